@@ -0,0 +1,180 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+constexpr uint64_t ALLOCATION_WARMUP_FRAMES = 100;
+
+#ifdef IFF_COUNT_ALLOCATIONS
+// allocations made by each thread while `enabled`, counted by the replaced `operator new` overloads
+namespace allocation_counter
+{
+    extern thread_local bool enabled;
+    extern thread_local uint64_t count;
+}
+#endif
+
+// Checks that a per-frame code path makes no heap allocations after warm-up.
+// Does nothing unless built with IFF_COUNT_ALLOCATIONS (CMake option of the same name).
+class allocation_check
+{
+public:
+    explicit allocation_check(const char* path) noexcept
+        : path_(path)
+    {
+    }
+
+    // counts allocations made by the current thread during one frame
+    class frame_scope
+    {
+    public:
+        explicit frame_scope(allocation_check& check) noexcept
+            : check_(check)
+        {
+#ifdef IFF_COUNT_ALLOCATIONS
+            start_ = allocation_counter::count;
+            allocation_counter::enabled = true;
+#endif
+        }
+
+        ~frame_scope()
+        {
+#ifdef IFF_COUNT_ALLOCATIONS
+            allocation_counter::enabled = false;
+            const auto allocations = allocation_counter::count - start_;
+            if(++check_.frames_ > ALLOCATION_WARMUP_FRAMES && allocations != 0)
+            {
+                std::fprintf(stderr, "%s: %llu heap allocation(s) in frame %llu after warm-up\n", check_.path_,
+                             static_cast<unsigned long long>(allocations), static_cast<unsigned long long>(check_.frames_));
+                std::abort();
+            }
+#else
+            static_cast<void>(check_);
+#endif
+        }
+
+        frame_scope(const frame_scope&) = delete;
+        frame_scope& operator=(const frame_scope&) = delete;
+
+    private:
+        allocation_check& check_;
+#ifdef IFF_COUNT_ALLOCATIONS
+        uint64_t start_ = 0;
+#endif
+    };
+
+    // whether allocations of the calling thread are counted for a frame right now
+    static bool counting() noexcept
+    {
+#ifdef IFF_COUNT_ALLOCATIONS
+        return allocation_counter::enabled;
+#else
+        return false;
+#endif
+    }
+
+    // adds allocations that helper threads made for the frame of the calling thread
+    static void charge(uint64_t allocations) noexcept
+    {
+#ifdef IFF_COUNT_ALLOCATIONS
+        allocation_counter::count += allocations;
+#else
+        static_cast<void>(allocations);
+#endif
+    }
+
+    // counts allocations of a thread working on the frame of another one (a stripe pool
+    // worker) into `allocations`, which that thread then passes to `charge()`
+    class helper_scope
+    {
+    public:
+        helper_scope(bool counting, std::atomic<uint64_t>& allocations) noexcept
+            : allocations_(allocations)
+        {
+#ifdef IFF_COUNT_ALLOCATIONS
+            start_ = allocation_counter::count;
+            allocation_counter::enabled = counting;
+#else
+            static_cast<void>(counting);
+#endif
+        }
+
+        ~helper_scope()
+        {
+#ifdef IFF_COUNT_ALLOCATIONS
+            allocation_counter::enabled = false;
+            allocations_.fetch_add(allocation_counter::count - start_, std::memory_order_relaxed);
+#else
+            static_cast<void>(allocations_);
+#endif
+        }
+
+        helper_scope(const helper_scope&) = delete;
+        helper_scope& operator=(const helper_scope&) = delete;
+
+    private:
+        std::atomic<uint64_t>& allocations_;
+#ifdef IFF_COUNT_ALLOCATIONS
+        uint64_t start_ = 0;
+#endif
+    };
+
+    // excludes calls into the SDK, whose allocations are outside of our control
+    class exempt
+    {
+    public:
+        exempt() noexcept
+        {
+#ifdef IFF_COUNT_ALLOCATIONS
+            was_enabled_ = std::exchange(allocation_counter::enabled, false);
+#endif
+        }
+
+        ~exempt()
+        {
+#ifdef IFF_COUNT_ALLOCATIONS
+            allocation_counter::enabled = was_enabled_;
+#endif
+        }
+
+        exempt(const exempt&) = delete;
+        exempt& operator=(const exempt&) = delete;
+
+#ifdef IFF_COUNT_ALLOCATIONS
+    private:
+        bool was_enabled_ = false;
+#endif
+    };
+
+private:
+    const char* path_;
+    uint64_t frames_ = 0;
+};
@@ -0,0 +1,179 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "async_logger.hpp"
+
+// std
+#include <cstdio>
+#include <cstring>
+
+async_logger::async_logger()
+    : slots_(LOG_QUEUE_CAPACITY)
+{
+    for(size_t i = 0; i < slots_.size(); ++i)
+    {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+void async_logger::stop()
+{
+    if(thread_.joinable())
+    {
+        running_ = false;
+        thread_.join();
+    }
+}
+
+void async_logger::log(site& site, iff::log_level level, const char* format, ...)
+{
+    site.level_.store(level, std::memory_order_relaxed);
+    const auto now = now_ns();
+    auto next_time = site.next_time_.load(std::memory_order_relaxed);
+    if(now < next_time || !site.next_time_.compare_exchange_strong(next_time, now + site.interval_, std::memory_order_relaxed))
+    {
+        site.suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const auto repeated = site.suppressed_.exchange(0, std::memory_order_relaxed);
+
+    std::va_list args;
+    va_start(args, format);
+    const auto written = enqueue(level, repeated, format, args);
+    va_end(args);
+    if(!written)
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool async_logger::enqueue(iff::log_level level, uint32_t repeated, const char* format, std::va_list args)
+{
+    constexpr size_t mask = LOG_QUEUE_CAPACITY - 1;
+    auto position = tail_.load(std::memory_order_relaxed);
+    slot* target;
+    while(true)
+    {
+        target = &slots_[position & mask];
+        const auto sequence = target->sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if(difference == 0)
+        {
+            if(tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if(difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+
+    target->level = level;
+    // the count survives truncation: a long message is cut to leave room for it
+    char suffix[64] = "";
+    size_t suffix_length = 0;
+    if(repeated != 0)
+    {
+        suffix_length = static_cast<size_t>(std::snprintf(suffix, sizeof(suffix), " (repeated %u times since last report)", repeated));
+    }
+    const auto room = LOG_MESSAGE_SIZE - suffix_length;
+    const auto length = std::vsnprintf(target->text, room, format, args);
+    if(suffix_length != 0 && length >= 0)
+    {
+        std::memcpy(target->text + std::min<size_t>(static_cast<size_t>(length), room - 1), suffix, suffix_length + 1);
+    }
+    target->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+void async_logger::drain_loop()
+{
+    while(true)
+    {
+        const bool last_pass = !running_;
+        drain();
+        report_suppressed(last_pass);
+        if(last_pass)
+        {
+            return;
+        }
+        std::this_thread::sleep_for(LOG_DRAIN_PERIOD);
+    }
+}
+
+void async_logger::drain()
+{
+    constexpr size_t mask = LOG_QUEUE_CAPACITY - 1;
+    while(true)
+    {
+        auto& source = slots_[head_ & mask];
+        if(source.sequence.load(std::memory_order_acquire) != head_ + 1)
+        {
+            break;
+        }
+        iff::log(source.level, "imagefiltercpp", source.text);
+        source.sequence.store(head_ + LOG_QUEUE_CAPACITY, std::memory_order_release);
+        ++head_;
+    }
+    if(const auto dropped = dropped_.exchange(0, std::memory_order_relaxed))
+    {
+        char message[LOG_MESSAGE_SIZE];
+        std::snprintf(message, sizeof(message), "Log queue overflow: %u message(s) dropped", dropped);
+        iff::log(iff::log_level::warning, "imagefiltercpp", message);
+    }
+}
+
+void async_logger::report_suppressed(bool flush)
+{
+    const auto now = now_ns();
+    std::scoped_lock<std::mutex> lock(sites_mutex_);
+    for(const auto site : sites_)
+    {
+        if(site->suppressed_.load(std::memory_order_relaxed) == 0)
+        {
+            continue;
+        }
+        auto next_time = site->next_time_.load(std::memory_order_relaxed);
+        if(!flush && now < next_time)
+        {
+            continue;
+        }
+        if(!site->next_time_.compare_exchange_strong(next_time, now + site->interval_, std::memory_order_relaxed))
+        {
+            continue;
+        }
+        if(const auto repeated = site->suppressed_.exchange(0, std::memory_order_relaxed))
+        {
+            char message[LOG_MESSAGE_SIZE];
+            std::snprintf(message, sizeof(message), "%s: last message repeated %u time(s)", site->key_.c_str(), repeated);
+            iff::log(site->level_.load(std::memory_order_relaxed), "imagefiltercpp", message);
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+constexpr size_t LOG_QUEUE_CAPACITY = 256; // must be a power of two
+constexpr size_t LOG_MESSAGE_SIZE = 256;
+constexpr auto LOG_DRAIN_PERIOD = std::chrono::milliseconds(20);
+constexpr auto LOG_RATE_LIMIT = std::chrono::seconds(1);
+
+// Logger for frame threads and SDK callbacks. Messages are formatted into
+// preallocated slots of a lock-free ring and passed to `iff::log` by a
+// background thread, so reporting never blocks or allocates on the caller.
+// Each site is rate limited: messages arriving within the site interval are
+// only counted and reported later as "repeated N times". Sites are keyed by
+// message and source (stream, output or chain element), so a storm from one
+// source does not hide messages of the others.
+class async_logger
+{
+public:
+    class site
+    {
+    public:
+        site(async_logger& logger, std::string key, std::chrono::nanoseconds interval = LOG_RATE_LIMIT)
+            : logger_(logger)
+            , key_(std::move(key))
+            , interval_(interval.count())
+        {
+            std::scoped_lock<std::mutex> lock(logger_.sites_mutex_);
+            logger_.sites_.push_back(this);
+        }
+
+        ~site()
+        {
+            std::scoped_lock<std::mutex> lock(logger_.sites_mutex_);
+            logger_.sites_.erase(std::find(logger_.sites_.begin(), logger_.sites_.end(), this));
+        }
+
+        site(const site&) = delete;
+        site& operator=(const site&) = delete;
+
+    private:
+        friend class async_logger;
+
+        async_logger& logger_;
+        const std::string key_;
+        const int64_t interval_;
+        std::atomic<int64_t> next_time_{0};
+        std::atomic<uint32_t> suppressed_{0};
+        std::atomic<iff::log_level> level_{iff::log_level::info};
+    };
+
+    async_logger();
+
+    ~async_logger()
+    {
+        stop();
+    }
+
+    void start()
+    {
+        running_ = true;
+        thread_ = std::thread([this](){ drain_loop(); });
+    }
+
+    void stop();
+
+    void log(site& site, iff::log_level level, const char* format, ...);
+
+private:
+    struct slot
+    {
+        std::atomic<size_t> sequence{0};
+        iff::log_level level = iff::log_level::info;
+        char text[LOG_MESSAGE_SIZE];
+    };
+
+    static int64_t now_ns()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool enqueue(iff::log_level level, uint32_t repeated, const char* format, std::va_list args);
+
+    void drain_loop();
+
+    void drain();
+
+    // reports messages that were coalesced and not followed by another one
+    void report_suppressed(bool flush);
+
+    std::vector<slot> slots_;
+    std::atomic<size_t> tail_{0};
+    size_t head_ = 0;
+    std::atomic<uint32_t> dropped_{0};
+
+    std::mutex sites_mutex_;
+    std::vector<site*> sites_;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
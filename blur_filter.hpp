@@ -0,0 +1,62 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "separable_convolution.hpp"
+#include "stripe_pool.hpp"
+
+// `gaussian_blur` and `box_blur` filters.
+class blur_filter final : public filter
+{
+public:
+    explicit blur_filter(std::vector<int32_t> kernel)
+        : convolution_(std::move(kernel))
+    {
+    }
+
+    bool scale_invariant() const noexcept override
+    {
+        return true;
+    }
+
+    void apply(const frame_view& frame, stripe_pool& pool) override
+    {
+        convolution_.apply(frame, pool, [](const uint8_t* filtered, uint8_t* destination, size_t count)
+        {
+            std::memcpy(destination, filtered, count);
+        });
+    }
+
+private:
+    separable_convolution convolution_;
+};
@@ -0,0 +1,63 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "crosshair_filter.hpp"
+
+void crosshair_filter::apply(const frame_view& frame, stripe_pool&)
+{
+    if(frame.width < 200 || frame.height < 200)
+    {
+        return;
+    }
+    for(uint32_t y = frame.height / 2 - 100; y < frame.height / 2 + 100; ++y)
+    {
+        for(uint32_t x = frame.width / 2 - 2; x < frame.width / 2 + 2; ++x)
+        {
+            paint(frame.row(y) + x * frame.channels, frame.channels);
+        }
+    }
+    for(uint32_t x = frame.width / 2 - 100; x < frame.width / 2 + 100; ++x)
+    {
+        for(uint32_t y = frame.height / 2 - 2; y < frame.height / 2 + 2; ++y)
+        {
+            paint(frame.row(y) + x * frame.channels, frame.channels);
+        }
+    }
+}
+
+void crosshair_filter::paint(uint8_t* pixel, uint32_t channels) noexcept
+{
+    if(channels == 1)
+    {
+        pixel[0] = 255;
+        return;
+    }
+    pixel[0] = 0;
+    pixel[1] = 0;
+    pixel[2] = 255;
+    if(channels == 4)
+    {
+        pixel[3] = 255;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "demand_tracker.hpp"
+
+bool demand_tracker::pulled(bool taken, std::chrono::steady_clock::time_point now)
+{
+    const auto ticks = now.time_since_epoch().count();
+    if(taken)
+    {
+        last_pulled_.store(ticks, std::memory_order_relaxed);
+        if(!active())
+        {
+            // a probe frame was taken, frames are pulled again
+            std::scoped_lock<std::mutex> lock(state_mutex_);
+            set_active(true, "frames pulled again");
+        }
+        return true;
+    }
+    if(!active())
+    {
+        return false;
+    }
+    if(ticks - last_pulled_.load(std::memory_order_relaxed) < idle_timeout_ticks())
+    {
+        return true;
+    }
+    std::scoped_lock<std::mutex> lock(state_mutex_);
+    // rechecked under the lock, a consumer may have connected meanwhile
+    if(ticks - last_pulled_.load(std::memory_order_relaxed) >= idle_timeout_ticks())
+    {
+        set_active(false, "no frames pulled");
+        next_probe_ = ticks + std::chrono::duration_cast<std::chrono::steady_clock::duration>(DEMAND_PROBE_PERIOD).count();
+    }
+    return active();
+}
+
+void demand_tracker::stop()
+{
+    if(stopped_)
+    {
+        return;
+    }
+    stopped_ = true;
+    // the chain outlives the tracker, its events must not reach it any more
+    chain_->set_callback(resume_event_, [](const std::string&){});
+    std::scoped_lock<std::mutex> lock(state_mutex_);
+    if(!active_)
+    {
+        idle_time += std::chrono::steady_clock::now() - idle_since_;
+    }
+}
+
+void demand_tracker::set_active(bool active, const char* cause)
+{
+    if(active_.exchange(active, std::memory_order_relaxed) == active)
+    {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if(active)
+    {
+        idle_time += now - idle_since_;
+    }
+    else
+    {
+        idle_since_ = now;
+        ++idle_periods;
+    }
+    logger_.log(change_log_, iff::log_level::info, "Stream `%s`: %s, processing %s", stream_id_.c_str(), cause, active ? "resumed" : "paused");
+    if(on_change)
+    {
+        on_change(active);
+    }
+}
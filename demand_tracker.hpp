@@ -0,0 +1,150 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "async_logger.hpp"
+#include "stream_config.hpp"
+
+constexpr auto DEMAND_PROBE_PERIOD = std::chrono::milliseconds(100);
+
+// Tracks whether anybody consumes the output of a stream. While nobody does,
+// the export callback returns frames right away, so an unwatched stream
+// costs no copy and no filtering; the camera chain keeps running. A consumer
+// appearing is the `on_new_consumer` event of a `sub_monitor` element, which
+// turns processing back on so the next frame is processed. There is no event
+// for the last consumer leaving, so that is inferred instead: once the
+// stream importer has taken no frame (no import buffer became free) for
+// `idle_timeout`, nothing downstream pulls frames any more and the stream
+// pauses. A paused stream still lets a probe frame through every
+// DEMAND_PROBE_PERIOD, and resumes when its importer takes it, so a stall of
+// connected consumers does not stop the stream for good. Streams start
+// active, so nothing is lost if the monitor never reports.
+class demand_tracker
+{
+public:
+    demand_tracker(const demand_config& config, const std::map<std::string, std::shared_ptr<iff::chain>>& chains, const std::string& stream_id, async_logger& logger)
+        : chain_(chains.at(config.monitor.chain))
+        , resume_event_(config.monitor.element + "/on_new_consumer")
+        , idle_timeout_(config.idle_timeout)
+        , stream_id_(stream_id)
+        , logger_(logger)
+        , change_log_(logger, "Stream `" + stream_id + "` demand", std::chrono::nanoseconds(0))
+    {
+    }
+
+    ~demand_tracker()
+    {
+        stop();
+    }
+
+    demand_tracker(const demand_tracker&) = delete;
+    demand_tracker& operator=(const demand_tracker&) = delete;
+
+    bool active() const noexcept
+    {
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    // called by the export callback, false for frames to return unprocessed;
+    // while paused, lets one probe frame through every DEMAND_PROBE_PERIOD
+    bool admit(std::chrono::steady_clock::time_point now) noexcept
+    {
+        if(active())
+        {
+            return true;
+        }
+        const auto ticks = now.time_since_epoch().count();
+        if(ticks < next_probe_)
+        {
+            return false;
+        }
+        next_probe_ = ticks + std::chrono::duration_cast<std::chrono::steady_clock::duration>(DEMAND_PROBE_PERIOD).count();
+        return true;
+    }
+
+    // called by the export callback with the outcome of taking an import buffer,
+    // false when the stream is paused and the frame is to be returned unprocessed
+    bool pulled(bool taken, std::chrono::steady_clock::time_point now);
+
+    void start()
+    {
+        last_pulled_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        chain_->set_callback(resume_event_, [this](const std::string&){ on_consumer(); });
+    }
+
+    void stop();
+
+    // run on every change of `active()`, e.g. to stop work that does not pass through the export callback
+    std::function<void(bool active)> on_change;
+
+    uint64_t idle_frames = 0; // returned unprocessed, written by the export callback
+    uint64_t idle_periods = 0;
+    std::chrono::steady_clock::duration idle_time{0};
+
+private:
+    std::chrono::steady_clock::rep idle_timeout_ticks() const noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(idle_timeout_).count();
+    }
+
+    void on_consumer()
+    {
+        std::scoped_lock<std::mutex> lock(state_mutex_);
+        // the new consumer gets a full timeout to start pulling frames
+        last_pulled_.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        set_active(true, "consumer connected");
+    }
+
+    // called with `state_mutex_` held
+    void set_active(bool active, const char* cause);
+
+    const std::shared_ptr<iff::chain> chain_;
+    const std::string resume_event_;
+    const std::chrono::milliseconds idle_timeout_;
+    const std::string stream_id_;
+    async_logger& logger_;
+    async_logger::site change_log_;
+    std::atomic<bool> active_{true};
+    std::atomic<std::chrono::steady_clock::rep> last_pulled_{0}; // steady clock ticks
+    std::chrono::steady_clock::rep next_probe_ = 0;              // export callback only
+    bool stopped_ = false;
+
+    std::mutex state_mutex_;
+    std::chrono::steady_clock::time_point idle_since_;
+};
@@ -0,0 +1,94 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "filter.hpp"
+
+// std
+#include <stdexcept>
+
+#include "blur_filter.hpp"
+#include "crosshair_filter.hpp"
+#include "lut3d_filter.hpp"
+#include "motion_detect_filter.hpp"
+#include "privacy_mask_filter.hpp"
+#include "region_stats_filter.hpp"
+#include "separable_convolution.hpp"
+#include "temporal_denoise_filter.hpp"
+#include "undistort_filter.hpp"
+#include "unsharp_mask_filter.hpp"
+
+std::unique_ptr<filter> make_filter(const nlohmann::json& config, const filter_context& context)
+{
+    const auto type = config.value("type", "");
+    if(type == "crosshair")
+    {
+        return std::make_unique<crosshair_filter>();
+    }
+    if(type == "temporal_denoise")
+    {
+        return std::make_unique<temporal_denoise_filter>(config);
+    }
+    if(type == "motion_detect")
+    {
+        return std::make_unique<motion_detect_filter>(config, context);
+    }
+    if(type == "region_stats")
+    {
+        return std::make_unique<region_stats_filter>(config, context);
+    }
+    if(type == "privacy_mask")
+    {
+        return std::make_unique<privacy_mask_filter>(config, context);
+    }
+    if(type == "undistort")
+    {
+        return std::make_unique<undistort_filter>(config);
+    }
+    if(type == "lut3d")
+    {
+        return std::make_unique<lut3d_filter>(config, context);
+    }
+    if(type == "gaussian_blur")
+    {
+        return std::make_unique<blur_filter>(unsharp_mask_filter::gaussian_kernel(config, 1.0));
+    }
+    if(type == "box_blur")
+    {
+        const auto radius = config.value("radius", 2u);
+        if(radius == 0 || radius > 15)
+        {
+            throw std::runtime_error("`radius` must be in [1, 15]");
+        }
+        return std::make_unique<blur_filter>(separable_convolution::box(radius));
+    }
+    if(type == "unsharp_mask")
+    {
+        return std::make_unique<unsharp_mask_filter>(config, 1.5);
+    }
+    if(type == "sharpen")
+    {
+        return std::make_unique<unsharp_mask_filter>(config, 0.7);
+    }
+    throw std::runtime_error("unknown filter type `" + type + "`");
+}
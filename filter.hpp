@@ -0,0 +1,73 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "async_logger.hpp"
+#include "frame_view.hpp"
+#include "integral_image.hpp"
+#include "stripe_pool.hpp"
+
+// In-place CPU filter applied by the processing thread of a stream.
+// Filters are created at startup from the `filters` list of a stream;
+// `apply()` runs once per frame and must not allocate unless frame geometry changes.
+class filter
+{
+public:
+    virtual ~filter() = default;
+    virtual void apply(const frame_view& frame, stripe_pool& pool) = 0;
+
+    // whether the filter may run on a downscaled copy of the frame: no pixel coordinates, overlays or calibration,
+    // and no state from earlier frames, which switching the resolution would throw away
+    virtual bool scale_invariant() const noexcept
+    {
+        return false;
+    }
+
+    // whether the next `apply()` reads the stream's integral image, which is only computed for such frames
+    virtual bool reads_integral() const noexcept
+    {
+        return false;
+    }
+};
+
+// What filters may need at construction besides their own configuration.
+struct filter_context
+{
+    const std::string& stream_id;
+    const std::string& format;  // importer pixel format
+    uint32_t channels;          // bytes per pixel
+    async_logger& logger;
+    integral_image& integral; // call `request()` and override `filter::reads_integral()` to have it computed
+};
+
+std::unique_ptr<filter> make_filter(const nlohmann::json& config, const filter_context& context);
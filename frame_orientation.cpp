@@ -0,0 +1,378 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_orientation.hpp"
+
+// std
+#include <algorithm>
+
+void frame_orientation::copy(const uint8_t* source, uint32_t width, uint32_t height, size_t stride, uint32_t channels, uint8_t* destination) const noexcept
+{
+    switch(channels)
+    {
+    case 1:
+        copy<1>(source, width, height, stride, destination);
+        break;
+    case 3:
+        copy<3>(source, width, height, stride, destination);
+        break;
+    default:
+        copy<4>(source, width, height, stride, destination);
+        break;
+    }
+}
+
+std::pair<int64_t, int64_t> frame_orientation::source_position(int64_t u, int64_t v, uint32_t width, uint32_t height) const noexcept
+{
+    // undo the rotation, giving a position in the mirrored frame
+    int64_t x = u;
+    int64_t y = v;
+    switch(rotation_)
+    {
+    case 90:
+        x = v;
+        y = int64_t(height) - 1 - u;
+        break;
+    case 180:
+        x = int64_t(width) - 1 - u;
+        y = int64_t(height) - 1 - v;
+        break;
+    case 270:
+        x = int64_t(width) - 1 - v;
+        y = u;
+        break;
+    }
+    if(flip_ == flip::horizontal)
+    {
+        x = int64_t(width) - 1 - x;
+    }
+    else if(flip_ == flip::vertical)
+    {
+        y = int64_t(height) - 1 - y;
+    }
+    return {x, y};
+}
+
+template<uint32_t Channels>
+void frame_orientation::copy(const uint8_t* source, uint32_t width, uint32_t height, size_t stride, uint8_t* destination) const noexcept
+{
+    const auto output_width = swaps_axes() ? height : width;
+    const auto output_height = swaps_axes() ? width : height;
+    const auto output_stride = size_t(output_width) * Channels;
+    // the mapping is affine, so three points give the origin and the steps along destination rows and columns
+    const auto offset = [&](int64_t u, int64_t v)
+    {
+        const auto [x, y] = source_position(u, v, width, height);
+        return x * Channels + y * int64_t(stride);
+    };
+    const auto origin = offset(0, 0);
+    const auto step_u = offset(1, 0) - origin;
+    const auto step_v = offset(0, 1) - origin;
+
+    if(step_u == Channels)
+    {
+        for(uint32_t v = 0; v < output_height; ++v)
+        {
+            std::memcpy(destination + v * output_stride, source + origin + v * step_v, output_stride);
+        }
+        return;
+    }
+    if(step_u == -int64_t(Channels))
+    {
+        for(uint32_t v = 0; v < output_height; ++v)
+        {
+            const uint8_t* input = source + origin + v * step_v;
+            uint8_t* output = destination + v * output_stride;
+            const auto reversed = reverse<Channels>(input, output, output_width);
+            input -= reversed * Channels;
+            output += reversed * Channels;
+            for(uint32_t u = reversed; u < output_width; ++u, input -= Channels, output += Channels)
+            {
+                for(uint32_t c = 0; c < Channels; ++c)
+                {
+                    output[c] = input[c];
+                }
+            }
+        }
+        return;
+    }
+    // destination rows run along source columns, each tile row is a source row segment, forward or backward
+    constexpr auto tile = TILE_SIZE<Channels>;
+    const bool tiled = tile != 0 && (step_v == Channels || step_v == -int64_t(Channels));
+    const auto copy_pixels = [&](uint32_t v, uint32_t u0, uint32_t u1)
+    {
+        const uint8_t* input = source + origin + v * step_v + u0 * step_u;
+        uint8_t* output = destination + v * output_stride + u0 * Channels;
+        for(uint32_t u = u0; u < u1; ++u, input += step_u, output += Channels)
+        {
+            for(uint32_t c = 0; c < Channels; ++c)
+            {
+                output[c] = input[c];
+            }
+        }
+    };
+    for(uint32_t v0 = 0; v0 < output_height; v0 += BLOCK_SIZE)
+    {
+        const auto v1 = std::min(v0 + BLOCK_SIZE, output_height);
+        for(uint32_t u0 = 0; u0 < output_width; u0 += BLOCK_SIZE)
+        {
+            const auto u1 = std::min(u0 + BLOCK_SIZE, output_width);
+            // full tiles, then the frame edges pixel by pixel
+            const auto tiled_u1 = tiled ? u0 + (u1 - u0) / tile * tile : u0;
+            const auto tiled_v1 = tiled ? v0 + (v1 - v0) / tile * tile : v0;
+            for(uint32_t v = v0; v < tiled_v1; v += tile)
+            {
+                for(uint32_t u = u0; u < tiled_u1; u += tile)
+                {
+                    transpose<Channels>(source + origin + v * step_v + u * step_u, step_u, step_v < 0,
+                                        destination + v * output_stride + u * Channels, output_stride);
+                }
+                for(uint32_t row = v; row < v + tile; ++row)
+                {
+                    copy_pixels(row, tiled_u1, u1);
+                }
+            }
+            for(uint32_t v = tiled_v1; v < v1; ++v)
+            {
+                copy_pixels(v, u0, u1);
+            }
+        }
+    }
+}
+
+#if defined(IFF_SSE2)
+void frame_orientation::store_rgb4(uint8_t* pixels, __m128i lanes) noexcept
+{
+    const auto m = _mm_and_si128(lanes, _mm_set1_epi32(0x00FFFFFF));
+    // six bytes in each half, then the halves joined
+    const auto z = _mm_or_si128(_mm_and_si128(m, _mm_set_epi32(0, -1, 0, -1)), _mm_slli_epi64(_mm_srli_epi64(m, 32), 24));
+    const auto x = _mm_or_si128(_mm_move_epi64(z), _mm_slli_si128(_mm_srli_si128(z, 8), 6));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(pixels), x);
+    const int32_t last = _mm_cvtsi128_si32(_mm_srli_si128(x, 8));
+    std::memcpy(pixels + 8, &last, sizeof(last));
+}
+
+#endif
+#if defined(IFF_NEON)
+void frame_orientation::transpose8x8(uint8x8_t (&r)[8]) noexcept
+{
+    const auto a0 = vtrn_u8(r[0], r[1]);
+    const auto a1 = vtrn_u8(r[2], r[3]);
+    const auto a2 = vtrn_u8(r[4], r[5]);
+    const auto a3 = vtrn_u8(r[6], r[7]);
+    const auto b0 = vtrn_u16(vreinterpret_u16_u8(a0.val[0]), vreinterpret_u16_u8(a1.val[0]));
+    const auto b1 = vtrn_u16(vreinterpret_u16_u8(a0.val[1]), vreinterpret_u16_u8(a1.val[1]));
+    const auto b2 = vtrn_u16(vreinterpret_u16_u8(a2.val[0]), vreinterpret_u16_u8(a3.val[0]));
+    const auto b3 = vtrn_u16(vreinterpret_u16_u8(a2.val[1]), vreinterpret_u16_u8(a3.val[1]));
+    const auto c0 = vtrn_u32(vreinterpret_u32_u16(b0.val[0]), vreinterpret_u32_u16(b2.val[0]));
+    const auto c1 = vtrn_u32(vreinterpret_u32_u16(b1.val[0]), vreinterpret_u32_u16(b3.val[0]));
+    const auto c2 = vtrn_u32(vreinterpret_u32_u16(b0.val[1]), vreinterpret_u32_u16(b2.val[1]));
+    const auto c3 = vtrn_u32(vreinterpret_u32_u16(b1.val[1]), vreinterpret_u32_u16(b3.val[1]));
+    r[0] = vreinterpret_u8_u32(c0.val[0]);
+    r[1] = vreinterpret_u8_u32(c1.val[0]);
+    r[2] = vreinterpret_u8_u32(c2.val[0]);
+    r[3] = vreinterpret_u8_u32(c3.val[0]);
+    r[4] = vreinterpret_u8_u32(c0.val[1]);
+    r[5] = vreinterpret_u8_u32(c1.val[1]);
+    r[6] = vreinterpret_u8_u32(c2.val[1]);
+    r[7] = vreinterpret_u8_u32(c3.val[1]);
+}
+
+#endif
+template<uint32_t Channels>
+void frame_orientation::transpose([[maybe_unused]] const uint8_t* input, [[maybe_unused]] int64_t step, [[maybe_unused]] bool backward,
+                      [[maybe_unused]] uint8_t* output, [[maybe_unused]] size_t output_stride) noexcept
+{
+    constexpr auto tile = TILE_SIZE<Channels>;
+    if constexpr(tile != 0)
+    {
+        // a backward segment is loaded from its lowest address, so its pixels land in reverse row order
+        const auto first = backward ? -int64_t(tile - 1) * Channels : 0;
+        const auto row = [&](uint32_t k){ return output + (backward ? tile - 1 - k : k) * output_stride; };
+#if defined(IFF_SSE2)
+        // written out rather than looped, -O2 does not unroll and would keep the tile in memory
+        if constexpr(Channels != 1)
+        {
+            const auto load = [&](uint32_t i)
+            {
+                const auto pixels = input + i * step + first;
+                return Channels == 4 ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels)) : load_rgb4(pixels);
+            };
+            const auto store = [&](uint32_t k, __m128i pixels)
+            {
+                if constexpr(Channels == 4)
+                {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(row(k)), pixels);
+                }
+                else
+                {
+                    store_rgb4(row(k), pixels);
+                }
+            };
+            const auto r0 = load(0);
+            const auto r1 = load(1);
+            const auto r2 = load(2);
+            const auto r3 = load(3);
+            const auto t0 = _mm_unpacklo_epi32(r0, r1);
+            const auto t1 = _mm_unpacklo_epi32(r2, r3);
+            const auto t2 = _mm_unpackhi_epi32(r0, r1);
+            const auto t3 = _mm_unpackhi_epi32(r2, r3);
+            store(0, _mm_unpacklo_epi64(t0, t1));
+            store(1, _mm_unpackhi_epi64(t0, t1));
+            store(2, _mm_unpacklo_epi64(t2, t3));
+            store(3, _mm_unpackhi_epi64(t2, t3));
+        }
+        else
+        {
+            const auto load = [&](uint32_t i){ return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input + i * step + first)); };
+            const auto a0 = _mm_unpacklo_epi8(load(0), load(1));
+            const auto a1 = _mm_unpacklo_epi8(load(2), load(3));
+            const auto a2 = _mm_unpacklo_epi8(load(4), load(5));
+            const auto a3 = _mm_unpacklo_epi8(load(6), load(7));
+            const auto b0 = _mm_unpacklo_epi16(a0, a1);
+            const auto b1 = _mm_unpackhi_epi16(a0, a1);
+            const auto b2 = _mm_unpacklo_epi16(a2, a3);
+            const auto b3 = _mm_unpackhi_epi16(a2, a3);
+            // each holds two destination rows
+            const auto store = [&](uint32_t k, __m128i rows)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(row(k)), rows);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(row(k + 1)), _mm_unpackhi_epi64(rows, rows));
+            };
+            store(0, _mm_unpacklo_epi32(b0, b2));
+            store(2, _mm_unpackhi_epi32(b0, b2));
+            store(4, _mm_unpacklo_epi32(b1, b3));
+            store(6, _mm_unpackhi_epi32(b1, b3));
+        }
+#elif defined(IFF_NEON)
+        if constexpr(Channels == 4)
+        {
+            uint32x4_t r[4];
+            for(uint32_t i = 0; i < 4; ++i)
+            {
+                r[i] = vreinterpretq_u32_u8(vld1q_u8(input + i * step + first));
+            }
+            const auto a = vtrnq_u32(r[0], r[1]);
+            const auto b = vtrnq_u32(r[2], r[3]);
+            vst1q_u8(row(0), vreinterpretq_u8_u32(vcombine_u32(vget_low_u32(a.val[0]), vget_low_u32(b.val[0]))));
+            vst1q_u8(row(1), vreinterpretq_u8_u32(vcombine_u32(vget_low_u32(a.val[1]), vget_low_u32(b.val[1]))));
+            vst1q_u8(row(2), vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(a.val[0]), vget_high_u32(b.val[0]))));
+            vst1q_u8(row(3), vreinterpretq_u8_u32(vcombine_u32(vget_high_u32(a.val[1]), vget_high_u32(b.val[1]))));
+        }
+        else if constexpr(Channels == 3)
+        {
+            // deinterleaved into planes, each transposed on its own
+            uint8x8_t planes[3][8];
+            for(uint32_t i = 0; i < 8; ++i)
+            {
+                const auto pixels = vld3_u8(input + i * step + first);
+                for(uint32_t c = 0; c < 3; ++c)
+                {
+                    planes[c][i] = pixels.val[c];
+                }
+            }
+            for(auto& plane : planes)
+            {
+                transpose8x8(plane);
+            }
+            for(uint32_t k = 0; k < 8; ++k)
+            {
+                const uint8x8x3_t pixels = {{planes[0][k], planes[1][k], planes[2][k]}};
+                vst3_u8(row(k), pixels);
+            }
+        }
+        else
+        {
+            uint8x8_t r[8];
+            for(uint32_t i = 0; i < 8; ++i)
+            {
+                r[i] = vld1_u8(input + i * step + first);
+            }
+            transpose8x8(r);
+            for(uint32_t k = 0; k < 8; ++k)
+            {
+                vst1_u8(row(k), r[k]);
+            }
+        }
+#endif
+    }
+}
+
+template<uint32_t Channels>
+uint32_t frame_orientation::reverse([[maybe_unused]] const uint8_t* input, [[maybe_unused]] uint8_t* output, [[maybe_unused]] uint32_t width) noexcept
+{
+    uint32_t u = 0;
+#if defined(IFF_SSE2)
+    if constexpr(Channels == 3)
+    {
+        for(; u + 4 <= width; u += 4, input -= 12, output += 12)
+        {
+            store_rgb4(output, _mm_shuffle_epi32(load_rgb4(input - 9), 0x1B));
+        }
+    }
+    else
+    {
+        constexpr uint32_t pixels = 16 / Channels;
+        for(; u + pixels <= width; u += pixels, input -= 16, output += 16)
+        {
+            auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + Channels - 16));
+            if constexpr(Channels == 1)
+            {
+                x = _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+                x = _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0x1B), 0x1B);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_shuffle_epi32(x, Channels == 1 ? 0x4E : 0x1B));
+        }
+    }
+#elif defined(IFF_NEON)
+    for(; u + 16 <= width; u += 16, input -= 16 * Channels, output += 16 * Channels)
+    {
+        const auto first = input + Channels - 16 * Channels;
+        const auto flip = [](uint8x16_t x){ x = vrev64q_u8(x); return vcombine_u8(vget_high_u8(x), vget_low_u8(x)); };
+        if constexpr(Channels == 1)
+        {
+            vst1q_u8(output, flip(vld1q_u8(first)));
+        }
+        else if constexpr(Channels == 3)
+        {
+            auto x = vld3q_u8(first);
+            for(auto& plane : x.val)
+            {
+                plane = flip(plane);
+            }
+            vst3q_u8(output, x);
+        }
+        else
+        {
+            auto x = vld4q_u8(first);
+            for(auto& plane : x.val)
+            {
+                plane = flip(plane);
+            }
+            vst4q_u8(output, x);
+        }
+    }
+#endif
+    return u;
+}
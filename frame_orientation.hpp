@@ -0,0 +1,125 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "simd.hpp"
+
+// Mirroring (`flip`) followed by clockwise rotation by a multiple of 90 degrees,
+// applied while a frame is copied from the export to the import buffer.
+// Transformations that keep rows in order copy them whole or reversed; the
+// ones that turn rows into columns walk the destination in 32x32 pixel blocks
+// so that the source lines a block reads stay in cache until it is finished.
+// Compilers do not vectorize the strided stores of a transpose, so within a
+// block 8x8 (1 byte per pixel, and 3 bytes on NEON) or 4x4 pixel tiles are
+// loaded as source row segments and transposed in SSE2 or NEON registers,
+// with 3-byte pixels widened to 32-bit lanes on SSE2; reversed rows are also
+// reversed in registers.
+class frame_orientation
+{
+public:
+    enum class flip
+    {
+        none,
+        horizontal,
+        vertical
+    };
+
+    frame_orientation(uint32_t rotation, flip flip)
+        : rotation_(rotation)
+        , flip_(flip)
+    {
+    }
+
+    bool identity() const noexcept
+    {
+        return rotation_ == 0 && flip_ == flip::none;
+    }
+
+    bool swaps_axes() const noexcept
+    {
+        return rotation_ == 90 || rotation_ == 270;
+    }
+
+    // `destination` receives tightly packed rows of the transformed frame
+    void copy(const uint8_t* source, uint32_t width, uint32_t height, size_t stride, uint32_t channels, uint8_t* destination) const noexcept;
+
+private:
+    static constexpr uint32_t BLOCK_SIZE = 32;
+
+    // source pixel shown at destination (`u`, `v`)
+    std::pair<int64_t, int64_t> source_position(int64_t u, int64_t v, uint32_t width, uint32_t height) const noexcept;
+
+    template<uint32_t Channels>
+    void copy(const uint8_t* source, uint32_t width, uint32_t height, size_t stride, uint8_t* destination) const noexcept;
+
+    // pixels per side of the tiles `transpose()` handles, 0 when it handles none
+#if defined(IFF_SSE2)
+    template<uint32_t Channels>
+    static constexpr uint32_t TILE_SIZE = Channels == 1 ? 8 : 4;
+#elif defined(IFF_NEON)
+    template<uint32_t Channels>
+    static constexpr uint32_t TILE_SIZE = Channels == 4 ? 4 : 8;
+#else
+    template<uint32_t Channels>
+    static constexpr uint32_t TILE_SIZE = 0;
+#endif
+
+#if defined(IFF_SSE2)
+    // four 3-byte pixels into the low bytes of 32-bit lanes, reading only their 12 bytes
+    static __m128i load_rgb4(const uint8_t* pixels) noexcept
+    {
+        int32_t last;
+        std::memcpy(&last, pixels + 8, sizeof(last));
+        const auto x = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels)), _mm_cvtsi32_si128(last));
+        return _mm_unpacklo_epi64(_mm_unpacklo_epi32(x, _mm_srli_si128(x, 3)), _mm_unpacklo_epi32(_mm_srli_si128(x, 6), _mm_srli_si128(x, 9)));
+    }
+
+    static void store_rgb4(uint8_t* pixels, __m128i lanes) noexcept;
+#endif
+
+#if defined(IFF_NEON)
+    static void transpose8x8(uint8x8_t (&r)[8]) noexcept;
+#endif
+
+    // Writes a `TILE_SIZE` square of destination pixels starting at `output`,
+    // whose rows are read from `input` onwards (or backwards when `backward`)
+    // and whose columns are `step` bytes apart in the source.
+    template<uint32_t Channels>
+    static void transpose([[maybe_unused]] const uint8_t* input, [[maybe_unused]] int64_t step, [[maybe_unused]] bool backward,
+                          [[maybe_unused]] uint8_t* output, [[maybe_unused]] size_t output_stride) noexcept;
+
+    // Writes pixels `input`, `input` - 1, ... to `output` onwards in whole
+    // vectors, returning how many of the `width` pixels it wrote.
+    template<uint32_t Channels>
+    static uint32_t reverse([[maybe_unused]] const uint8_t* input, [[maybe_unused]] uint8_t* output, [[maybe_unused]] uint32_t width) noexcept;
+
+    const uint32_t rotation_;
+    const flip flip_;
+};
@@ -0,0 +1,175 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_pacer.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "tracer.hpp"
+
+frame_pacer::frame_pacer(const pacing_config& config, const std::string& stream_id, async_logger& logger)
+    : stream_id_(stream_id)
+    , period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / config.fps)))
+    , min_depth_(config.min_depth)
+    , max_depth_(config.max_depth)
+    , shrink_ticks_(std::max<uint64_t>(1, PACING_SHRINK_INTERVAL / period_))
+    , entries_(config.max_depth)
+    , target_(config.min_depth)
+    , mean_gap_(1.0 / config.fps)
+    , logger_(logger)
+    , overflow_log_(logger, "Stream `" + stream_id + "` pacing overflow")
+    , depth_log_(logger, "Stream `" + stream_id + "` pacing depth")
+{
+    max_target = target_;
+}
+
+void frame_pacer::start()
+{
+    thread_ = std::thread([this]()
+    {
+        tracer::name_thread("pacer " + stream_id_);
+        const tracer::context_scope trace(stream_id_.c_str(), 0);
+        run();
+    });
+}
+
+void frame_pacer::stop()
+{
+    if(thread_.joinable())
+    {
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+}
+
+void frame_pacer::offer(import_buffer&& buffer)
+{
+    const auto now = std::chrono::steady_clock::now();
+    import_buffer dropped;
+    std::scoped_lock<std::mutex> lock(mutex_);
+    if(last_arrival_ != std::chrono::steady_clock::time_point{})
+    {
+        // interarrival jitter as in RFC 3550, measured on arrival times against their running mean
+        const auto gap = std::chrono::duration<double>(now - last_arrival_).count();
+        jitter_ += (std::abs(gap - mean_gap_) - jitter_) / 16.0;
+        mean_gap_ += (gap - mean_gap_) / 16.0;
+    }
+    last_arrival_ = now;
+    if(count_ == entries_.size())
+    {
+        dropped = std::move(pop().buffer);
+        ++overflows;
+        logger_.log(overflow_log_, iff::log_level::warning, "Stream `%s`: pacing buffer full, dropping oldest frame", stream_id_.c_str());
+    }
+    auto& added = entries_[(head_ + count_++) % entries_.size()];
+    added.buffer = std::move(buffer);
+    added.arrival = now;
+}
+
+void frame_pacer::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true)
+    {
+        next += period_;
+        if(cv_.wait_until(lock, next, [this](){ return stop_; }))
+        {
+            return;
+        }
+        auto buffer = tick();
+        lock.unlock();
+        buffer.push();
+        lock.lock();
+        const auto now = std::chrono::steady_clock::now();
+        if(now >= next + period_)
+        {
+            missed_ticks += static_cast<uint64_t>((now - next) / period_);
+            next = now;
+        }
+    }
+}
+
+import_buffer frame_pacer::tick()
+{
+    // one frame absorbs arrivals late by less than the tick phase, each further one a period of peak jitter
+    const auto jitter_depth = std::clamp(1 + static_cast<uint32_t>(3.0 * jitter_ / std::chrono::duration<double>(period_).count()), min_depth_, max_depth_);
+    if(++ticks_since_underrun_ >= shrink_ticks_ && target_ > jitter_depth)
+    {
+        set_target(target_ - 1, "no underruns");
+        ticks_since_underrun_ = 0;
+    }
+    if(jitter_depth > target_)
+    {
+        set_target(jitter_depth, "arrival jitter");
+    }
+    if(buffering_ && count_ < target_)
+    {
+        return {};
+    }
+    buffering_ = false;
+    if(count_ == 0)
+    {
+        ++underruns;
+        ticks_since_underrun_ = 0;
+        buffering_ = true;
+        if(target_ < max_depth_)
+        {
+            set_target(target_ + 1, "underrun");
+        }
+        return {};
+    }
+    while(count_ > target_ + 1)
+    {
+        pop().buffer.reset();
+        ++trimmed;
+    }
+    depth_total += count_;
+    auto& released = pop();
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - released.arrival);
+    latency_total += latency;
+    latency_max = std::max(latency_max, latency);
+    ++frames;
+    return std::move(released.buffer);
+}
+
+void frame_pacer::set_target(uint32_t target, const char* cause)
+{
+    buffering_ = buffering_ || target > target_;
+    target_ = target;
+    max_target = std::max(max_target, target);
+    logger_.log(depth_log_, iff::log_level::info, "Stream `%s`: pacing depth %u frames (%s, jitter %.1f ms)",
+                stream_id_.c_str(), target, cause, jitter_ * 1e3);
+}
@@ -0,0 +1,127 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_logger.hpp"
+#include "import_buffer.hpp"
+#include "stream_config.hpp"
+
+constexpr auto PACING_SHRINK_INTERVAL = std::chrono::seconds(10);
+
+// Releases the frames of a stream to its importer at a fixed cadence, so
+// bursts from the exporter or uneven filter times do not reach the encoder.
+// Frames wait in a jitter buffer whose target depth follows the observed
+// arrival jitter: it grows by a frame on every underrun and shrinks again
+// after PACING_SHRINK_INTERVAL without one. Playback starts (and restarts
+// after an underrun) once the target depth is buffered; frames beyond one
+// more than the target are dropped at a tick so latency does not creep up
+// when the source runs slightly faster than the cadence.
+class frame_pacer
+{
+public:
+    frame_pacer(const pacing_config& config, const std::string& stream_id, async_logger& logger);
+
+    ~frame_pacer()
+    {
+        stop();
+    }
+
+    frame_pacer(const frame_pacer&) = delete;
+    frame_pacer& operator=(const frame_pacer&) = delete;
+
+    void start();
+
+    void stop();
+
+    // called by whichever thread finished the frame; frames must arrive in order
+    void offer(import_buffer&& buffer);
+
+    // written by the pacing thread, read after `stop()`
+    uint64_t frames = 0;
+    uint64_t underruns = 0;    // ticks without a frame to release
+    uint64_t overflows = 0;    // frames dropped because the buffer was full
+    uint64_t trimmed = 0;      // frames dropped to bring the depth back to the target
+    uint64_t missed_ticks = 0; // ticks skipped after the thread fell behind
+    uint64_t depth_total = 0;  // sum of buffered frames at each release
+    uint32_t max_target = 0;
+    std::chrono::microseconds latency_total{0}; // time from `offer()` to the push
+    std::chrono::microseconds latency_max{0};
+
+private:
+    struct entry
+    {
+        import_buffer buffer;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    entry& pop() noexcept
+    {
+        auto& front = entries_[head_];
+        head_ = (head_ + 1) % entries_.size();
+        --count_;
+        return front;
+    }
+
+    void run();
+
+    // picks the frame to push at this tick, called with the lock held
+    import_buffer tick();
+
+    // a deeper buffer fills by pausing playback, a shallower one drains by trimming
+    void set_target(uint32_t target, const char* cause);
+
+    const std::string stream_id_;
+    const std::chrono::steady_clock::duration period_;
+    const uint32_t min_depth_;
+    const uint32_t max_depth_;
+    const uint64_t shrink_ticks_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::vector<entry> entries_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+    uint32_t target_;
+    bool buffering_ = true;
+    uint64_t ticks_since_underrun_ = 0;
+    double jitter_ = 0.0; // seconds
+    double mean_gap_;
+    std::chrono::steady_clock::time_point last_arrival_;
+    std::thread thread_;
+
+    async_logger& logger_;
+    async_logger::site overflow_log_;
+    async_logger::site depth_log_;
+};
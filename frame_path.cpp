@@ -0,0 +1,412 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_path.hpp"
+
+// std
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#endif
+
+#include "allocation_check.hpp"
+#include "frame_synchronizer.hpp"
+#include "perf_counters.hpp"
+#include "probes.hpp"
+#include "tracer.hpp"
+
+constexpr uint32_t SPINS_PER_YIELD = 64;
+
+// hints the CPU that we are busy-waiting
+static void cpu_relax() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Busy-waits until a frame is queued, stop is requested or the budget runs out.
+static bool spin_wait(const stream& stream)
+{
+    const auto deadline = std::chrono::steady_clock::now() + stream.spin_budget;
+    uint32_t spins = 0;
+    while(stream.queued_frames.load(std::memory_order_acquire) == 0 && !stream.stop_processing.load(std::memory_order_relaxed))
+    {
+        if(++spins % SPINS_PER_YIELD == 0)
+        {
+            if(std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        else
+        {
+            cpu_relax();
+        }
+    }
+    return true;
+}
+
+frame_path::frame_path(stripe_pool& pool, async_logger& logger)
+    : pool_(pool)
+    , logger_(logger)
+{
+}
+
+void frame_path::receive(stream& stream, const void* const data, const size_t size, const iff::image_metadata& metadata)
+{
+    const allocation_check::frame_scope frame(stream.export_allocations);
+    const tracer::context_scope trace_context(stream.id.c_str(), metadata.frame_number);
+    const tracer::span trace("export callback");
+    IFF_PROBE4(export_received, stream.id.c_str(), metadata.frame_number, size, metadata.timestamp);
+    if(stream.demand && !stream.demand->admit(std::chrono::steady_clock::now()))
+    {
+        ++stream.demand->idle_frames;
+        return;
+    }
+    if(stream.frame_rate && !stream.frame_rate->admit(std::chrono::steady_clock::now()))
+    {
+        return;
+    }
+    if(stream.shedder && stream.shedder->skip_frame())
+    {
+        return;
+    }
+    // taken on receipt, the capture timestamp is not on the steady clock
+    const auto deadline = stream.latency_budget.count() > 0 ? std::chrono::steady_clock::now() + stream.latency_budget
+                                                            : std::chrono::steady_clock::time_point::max();
+    auto buffer = import_buffer::acquire(stream.importer);
+    if(stream.demand && !stream.demand->pulled(static_cast<bool>(buffer), std::chrono::steady_clock::now()))
+    {
+        ++stream.demand->idle_frames;
+        return;
+    }
+    if(!buffer)
+    {
+        IFF_PROBE4(buffer_failed, stream.id.c_str(), metadata.frame_number, size, metadata.timestamp);
+        ++stream.import_drops;
+    }
+    else
+    {
+        IFF_PROBE4(buffer_acquired, stream.id.c_str(), metadata.frame_number, buffer.size(), metadata.timestamp);
+        // a reoriented frame is written without row padding
+        const auto needed = stream.orientation.identity() ? size : size_t(metadata.width) * metadata.height * stream.channels;
+        if(buffer.size() >= needed)
+        {
+            if(stream.orientation.identity())
+            {
+                const tracer::span trace_copy("copy");
+                const perf_counters::stage counted("copy", uint64_t(metadata.width) * metadata.height);
+                std::memcpy(buffer.data(), data, size);
+                buffer.set_metadata(metadata);
+            }
+            else
+            {
+                const tracer::span trace_copy("copy");
+                const perf_counters::stage counted("copy", uint64_t(metadata.width) * metadata.height);
+                stream.orientation.copy(static_cast<const uint8_t*>(data), metadata.width, metadata.height,
+                                        size_t(metadata.width) * stream.channels + metadata.padding, stream.channels, buffer.data());
+                auto oriented = metadata;
+                if(stream.orientation.swaps_axes())
+                {
+                    std::swap(oriented.width, oriented.height);
+                }
+                oriented.padding = 0;
+                buffer.set_metadata(oriented);
+            }
+            bool queued;
+            bool wake;
+            {
+                std::scoped_lock<std::mutex> lock(stream.mutex);
+                const auto buffer_size = buffer.size();
+                queued = stream.queue.push(std::move(buffer), deadline);
+                if(queued)
+                {
+                    IFF_PROBE4(enqueued, stream.id.c_str(), metadata.frame_number, buffer_size, metadata.timestamp);
+                    stream.queued_frames.fetch_add(1, std::memory_order_release);
+                }
+                wake = stream.parked;
+            }
+            if(wake)
+            {
+                stream.cv.notify_all();
+            }
+            if(!queued)
+            {
+                logger_.log(stream.queue_full_log, iff::log_level::error, "Stream `%s`: processing queue is full, dropping frame", stream.id.c_str());
+            }
+        }
+        else
+        {
+            logger_.log(stream.buffer_size_log, iff::log_level::error, "Stream `%s`: got import buffer size less than export buffer size (%zu < %zu)", stream.id.c_str(), buffer.size(), needed);
+        }
+    }
+}
+
+void frame_path::process(stream& stream)
+{
+    tracer::name_thread("processing " + stream.id);
+    std::unique_lock<std::mutex> lock(stream.mutex);
+    while(true)
+    {
+        while(!stream.queue.empty())
+        {
+            const allocation_check::frame_scope frame(stream.processing_allocations);
+            auto entry = stream.queue.pop();
+            auto& buffer = entry.buffer;
+            stream.queued_frames.fetch_sub(1, std::memory_order_relaxed);
+            lock.unlock();
+            IFF_PROBE4(dequeued, stream.id.c_str(), buffer.metadata().frame_number, buffer.size(), buffer.metadata().timestamp);
+            const tracer::context_scope trace(stream.id.c_str(), buffer.metadata().frame_number);
+            if(const auto active = tracer::instance())
+            {
+                active->record("queue wait", tracer::current(), entry.queued, std::chrono::steady_clock::now());
+            }
+
+            // output that would arrive too late is not worth the CPU time
+            const bool late = entry.deadline < std::chrono::steady_clock::now();
+            if(late)
+            {
+                ++stream.late_frames;
+                if(stream.late == late_policy::drop)
+                {
+                    buffer.reset();
+                    lock.lock();
+                    continue;
+                }
+            }
+            const stripe_pool::deadline_scope frame_deadline(entry.deadline);
+
+            const auto& metadata = buffer.metadata();
+            const frame_view view{buffer.data(), metadata.width, metadata.height,
+                                  size_t(metadata.width) * stream.channels + metadata.padding, stream.channels};
+            const auto filter_start = std::chrono::steady_clock::now();
+            if(stream.shedder && stream.shedder->take_change())
+            {
+                // filters and scalers adapt to the new frame size once
+                const allocation_check::exempt reconfigure;
+                apply_filters(stream, view, metadata, late);
+            }
+            else
+            {
+                apply_filters(stream, view, metadata, late);
+            }
+            if(stream.shedder)
+            {
+                stream.shedder->record(std::chrono::steady_clock::now() - filter_start);
+            }
+            {
+                const tracer::span trace_outputs("outputs");
+                deliver_outputs(stream, view, metadata);
+            }
+            if(stream.synchronizer != nullptr)
+            {
+                stream.synchronizer->offer(stream.synchronizer_member, std::move(buffer), [&](size_t member, import_buffer& frame)
+                {
+                    release_frame(*stream.synchronizer->members[member], frame);
+                });
+            }
+            else
+            {
+                release_frame(stream, buffer);
+            }
+            ++stream.frames_processed;
+            lock.lock();
+        }
+        if(stream.stop_processing)
+        {
+            return;
+        }
+        if(stream.spin_budget.count() > 0)
+        {
+            lock.unlock();
+            const auto hit = spin_wait(stream);
+            lock.lock();
+            if(hit)
+            {
+                ++stream.spin_hits;
+                continue;
+            }
+        }
+        if(stream.queue.empty())
+        {
+            ++stream.parks;
+            stream.parked = true;
+            stream.cv.wait(lock);
+            stream.parked = false;
+        }
+    }
+}
+
+void frame_path::apply_filters(stream& stream, const frame_view& view, const iff::image_metadata& metadata, bool late)
+{
+    const bool skip_optional = late || (stream.shedder && stream.shedder->optional_filters_off());
+    if(stream.integral->requested())
+    {
+        // only for frames where a filter that runs is going to read it
+        bool read = false;
+        for(size_t i = 0; i < stream.filters.size() && !read; ++i)
+        {
+            read = !(skip_optional && stream.optional_filters[i]) && stream.filters[i]->reads_integral();
+        }
+        if(read)
+        {
+            const tracer::span trace("integral image");
+            stream.integral->compute(view, pool_);
+        }
+    }
+    size_t first = 0;
+    bool scaled_work = false;
+    for(size_t i = 0; i < stream.scalable_filters && !scaled_work; ++i)
+    {
+        scaled_work = !(skip_optional && stream.optional_filters[i]);
+    }
+    // without a filter to run on it, the half-size copy would only cost two passes and resolution
+    if(scaled_work && stream.shedder && stream.shedder->half_resolution())
+    {
+        const frame_view half{nullptr, (view.width + 1) / 2, (view.height + 1) / 2, size_t((view.width + 1) / 2) * view.channels, view.channels};
+        stream.half_frame.resize(half.stride * half.height);
+        const frame_view small{stream.half_frame.data(), half.width, half.height, half.stride, half.channels};
+        {
+            const tracer::span trace("shrink");
+            stream.shrink.scale(view, small, pool_);
+        }
+        for(; first < stream.scalable_filters; ++first)
+        {
+            if(!(skip_optional && stream.optional_filters[first]))
+            {
+                const tracer::span trace(stream.filter_names[first].c_str());
+                const perf_counters::stage counted(stream.filter_names[first].c_str(), uint64_t(small.width) * small.height);
+                IFF_PROBE5(filter_start, stream.id.c_str(), metadata.frame_number, small.stride * small.height, metadata.timestamp, stream.filter_names[first].c_str());
+                stream.filters[first]->apply(small, pool_);
+                IFF_PROBE5(filter_end, stream.id.c_str(), metadata.frame_number, small.stride * small.height, metadata.timestamp, stream.filter_names[first].c_str());
+            }
+        }
+        const tracer::span trace("enlarge");
+        stream.enlarge.scale(small, view, pool_);
+    }
+    for(size_t i = first; i < stream.filters.size(); ++i)
+    {
+        if(!(skip_optional && stream.optional_filters[i]))
+        {
+            const tracer::span trace(stream.filter_names[i].c_str());
+            const perf_counters::stage counted(stream.filter_names[i].c_str(), uint64_t(view.width) * view.height);
+            IFF_PROBE5(filter_start, stream.id.c_str(), metadata.frame_number, view.stride * view.height, metadata.timestamp, stream.filter_names[i].c_str());
+            stream.filters[i]->apply(view, pool_);
+            IFF_PROBE5(filter_end, stream.id.c_str(), metadata.frame_number, view.stride * view.height, metadata.timestamp, stream.filter_names[i].c_str());
+        }
+    }
+}
+
+void frame_path::deliver_outputs(stream& stream, const frame_view& view, const iff::image_metadata& metadata)
+{
+    stream.full_size_outputs.clear();
+    for(auto& output : stream.outputs)
+    {
+        const auto [width, height] = output.size(view.width, view.height);
+        auto buffer = import_buffer::acquire(output.importer);
+        if(!buffer)
+        {
+            ++output.drops;
+            logger_.log(stream.output_drop_log, iff::log_level::warning, "Stream `%s`: no free buffer in output `%s`, dropping frame", stream.id.c_str(), output.name.c_str());
+            continue;
+        }
+        const auto row_size = size_t(width) * output.channels;
+        if(buffer.size() < row_size * height)
+        {
+            ++output.too_small;
+            logger_.log(stream.output_size_log, iff::log_level::error, "Stream `%s`: output `%s` import buffer is too small for %ux%u frames (%zu < %zu)",
+                       stream.id.c_str(), output.name.c_str(), width, height, buffer.size(), row_size * height);
+            continue;
+        }
+        auto output_metadata = metadata;
+        output_metadata.width = width;
+        output_metadata.height = height;
+        output_metadata.padding = 0;
+        buffer.set_metadata(output_metadata);
+        if(width == view.width && height == view.height)
+        {
+            output.pending = std::move(buffer);
+            stream.full_size_outputs.push_back(&output);
+            continue;
+        }
+        output.scaler.scale(view, frame_view{buffer.data(), width, height, row_size, output.channels}, pool_);
+        buffer.push();
+        ++output.frames;
+    }
+    if(stream.full_size_outputs.empty())
+    {
+        return;
+    }
+    pool_.run(view.height, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = begin; y < end; ++y)
+        {
+            for(const auto output : stream.full_size_outputs)
+            {
+                output->conversion.apply(view.row(y), output->pending.data() + size_t(y) * view.width * output->channels, view.width);
+            }
+        }
+    });
+    for(const auto output : stream.full_size_outputs)
+    {
+        output->pending.push();
+        ++output->frames;
+    }
+}
+
+void frame_path::release_frame(stream& stream, import_buffer& buffer)
+{
+    const auto& metadata = buffer.metadata();
+    const tracer::context_scope trace(stream.id.c_str(), metadata.frame_number);
+    const frame_view view{buffer.data(), metadata.width, metadata.height,
+                          size_t(metadata.width) * stream.channels + metadata.padding, stream.channels};
+    for(const auto tile : stream.mosaic_tiles)
+    {
+        tile->update(view, pool_);
+    }
+    if(stream.frame_rate && stream.frame_rate->fill_gaps)
+    {
+        stream.frame_rate->keep(buffer.data(), size_t(metadata.height) * view.stride, metadata);
+    }
+    if(stream.pacer)
+    {
+        stream.pacer->offer(std::move(buffer));
+    }
+    else
+    {
+        buffer.push();
+    }
+}
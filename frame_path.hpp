@@ -0,0 +1,70 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstddef>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "async_logger.hpp"
+#include "frame_view.hpp"
+#include "import_buffer.hpp"
+#include "stream.hpp"
+#include "stripe_pool.hpp"
+
+// Per-frame work of the streams: the export callback copies a frame into an
+// import buffer and queues it, and the processing thread of the stream filters
+// it and passes it on to outputs, mosaic tiles, synchronizer and pacer.
+// Filters of all streams split their frames across the threads of one pool.
+class frame_path
+{
+public:
+    frame_path(stripe_pool& pool, async_logger& logger);
+
+    frame_path(const frame_path&) = delete;
+    frame_path& operator=(const frame_path&) = delete;
+
+    // export callback of `stream`
+    void receive(stream& stream, const void* data, size_t size, const iff::image_metadata& metadata);
+
+    // processing thread of `stream`, returns once it is asked to stop
+    void process(stream& stream);
+
+private:
+    void apply_filters(stream& stream, const frame_view& view, const iff::image_metadata& metadata, bool late);
+
+    // Outputs of the frame's size are filled together, reading each source row
+    // once for all of them; others are scaled one by one.
+    void deliver_outputs(stream& stream, const frame_view& view, const iff::image_metadata& metadata);
+
+    // last steps of a frame, possibly delayed by a synchronizer and run by another stream's thread
+    void release_frame(stream& stream, import_buffer& buffer);
+
+    stripe_pool& pool_;
+    async_logger& logger_;
+};
@@ -0,0 +1,178 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_rate_converter.hpp"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "allocation_check.hpp"
+#include "tracer.hpp"
+
+frame_rate_converter::frame_rate_converter(const frame_rate_config& config, const import_target& importer, const std::string& stream_id, async_logger& logger)
+    : fill_gaps(config.fill_gaps)
+    , importer_(importer)
+    , stream_id_(stream_id)
+    , period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / config.fps)))
+    , logger_(logger)
+    , repeat_log_(logger, "Stream `" + stream_id + "` frame repeat dropped")
+{
+}
+
+bool frame_rate_converter::admit(std::chrono::steady_clock::time_point now) noexcept
+{
+    // frames up to a quarter period early still count, so arrival jitter does not skip a wanted frame
+    if(now < next_due_ - period_ / 4)
+    {
+        ++decimated;
+        return false;
+    }
+    next_due_ += period_;
+    if(next_due_ <= now)
+    {
+        // input slower than `fps`, or the first frame: follow the input
+        next_due_ = now + period_;
+    }
+    return true;
+}
+
+void frame_rate_converter::start()
+{
+    if(fill_gaps)
+    {
+        thread_ = std::thread([this]()
+        {
+            tracer::name_thread("frame repeat " + stream_id_);
+            const tracer::context_scope trace(stream_id_.c_str(), 0);
+            run();
+        });
+    }
+}
+
+void frame_rate_converter::stop()
+{
+    if(thread_.joinable())
+    {
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+}
+
+void frame_rate_converter::keep(const uint8_t* data, size_t size, const iff::image_metadata& metadata)
+{
+    const auto now = std::chrono::steady_clock::now();
+    auto& kept = slots_[back_];
+    if(size > kept.data.capacity())
+    {
+        const allocation_check::exempt resize; // once per slot and frame size
+        kept.data.reserve(size);
+    }
+    kept.data.assign(data, data + size);
+    kept.metadata = metadata;
+    kept.arrival = now;
+    if(previous_arrival_ != std::chrono::steady_clock::time_point{} && metadata.timestamp > previous_timestamp_)
+    {
+        const auto rate = double(metadata.timestamp - previous_timestamp_) / std::chrono::duration<double>(now - previous_arrival_).count();
+        estimated_rate_ = estimated_rate_ == 0.0 ? rate : estimated_rate_ + (rate - estimated_rate_) / 16.0;
+    }
+    previous_timestamp_ = metadata.timestamp;
+    previous_arrival_ = now;
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        std::swap(back_, middle_);
+        fresh_ = true;
+        kept_ = true;
+        timestamp_rate_ = estimated_rate_;
+        next_repeat_ = now + period_ + period_ / 2;
+    }
+    cv_.notify_all();
+}
+
+void frame_rate_converter::set_idle(bool idle)
+{
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        idle_ = idle;
+        if(idle)
+        {
+            kept_ = false;
+        }
+    }
+    cv_.notify_all();
+}
+
+void frame_rate_converter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(!stop_)
+    {
+        if(!kept_ || idle_)
+        {
+            cv_.wait(lock);
+            continue;
+        }
+        const auto due = next_repeat_;
+        if(cv_.wait_until(lock, due, [&](){ return stop_ || idle_ || next_repeat_ != due; }))
+        {
+            continue; // stopped, idle, or a new frame arrived
+        }
+        if(fresh_)
+        {
+            std::swap(front_, middle_);
+            fresh_ = false;
+        }
+        const auto rate = timestamp_rate_;
+        lock.unlock();
+        repeat(slots_[front_], rate);
+        lock.lock();
+        // a frame kept meanwhile moved the next repeat already
+        if(next_repeat_ == due)
+        {
+            next_repeat_ = std::max(due + period_, std::chrono::steady_clock::now());
+        }
+    }
+}
+
+void frame_rate_converter::repeat(const slot& frame, double timestamp_rate)
+{
+    auto buffer = import_buffer::acquire(importer_);
+    if(!buffer || buffer.size() < frame.data.size())
+    {
+        ++repeat_drops;
+        logger_.log(repeat_log_, iff::log_level::warning, "Stream `%s`: no import buffer to repeat the last frame", stream_id_.c_str());
+        return;
+    }
+    std::memcpy(buffer.data(), frame.data.data(), frame.data.size());
+    auto metadata = frame.metadata;
+    metadata.timestamp += static_cast<uint64_t>(timestamp_rate * std::chrono::duration<double>(std::chrono::steady_clock::now() - frame.arrival).count() + 0.5);
+    buffer.set_metadata(metadata);
+    buffer.push();
+    ++repeated;
+}
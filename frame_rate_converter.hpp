@@ -0,0 +1,127 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "async_logger.hpp"
+#include "import_buffer.hpp"
+#include "stream_config.hpp"
+
+// Converts the frame rate of a stream to `fps`. Faster input is decimated in
+// the export callback, before an import buffer is taken, so skipped frames
+// cost no copy and no filtering. With `fill_gaps`, a copy of each frame
+// pushed to the importer is kept, and when no new frame arrives within one
+// and a half periods it is pushed again into a fresh import buffer, once per
+// period until frames return. Timestamps of repeated frames advance with the
+// rate of the exporter's timestamp clock, estimated from the frames received.
+// Kept frames are triple-buffered: `keep()` copies into a slot of its own and
+// the repeat thread pushes from another, so the lock only guards swapping
+// slot indices and a slow push never holds up frame processing.
+class frame_rate_converter
+{
+public:
+    frame_rate_converter(const frame_rate_config& config, const import_target& importer, const std::string& stream_id, async_logger& logger);
+
+    ~frame_rate_converter()
+    {
+        stop();
+    }
+
+    frame_rate_converter(const frame_rate_converter&) = delete;
+    frame_rate_converter& operator=(const frame_rate_converter&) = delete;
+
+    // called by the export callback; false for frames that decimation skips
+    bool admit(std::chrono::steady_clock::time_point now) noexcept;
+
+    void start();
+
+    void stop();
+
+    // called with every frame about to be pushed to the stream importer when filling gaps;
+    // calls for one stream are serialized (its processing thread or its synchronizer)
+    void keep(const uint8_t* data, size_t size, const iff::image_metadata& metadata);
+
+    // while idle, gaps are not filled and the kept frame is dropped
+    void set_idle(bool idle);
+
+    const bool fill_gaps;
+
+    // `decimated` is written by the export callback, the rest by the repeat thread; read after both stopped
+    uint64_t decimated = 0;
+    uint64_t repeated = 0;
+    uint64_t repeat_drops = 0; // no free import buffer or buffer too small
+
+private:
+    struct slot
+    {
+        std::vector<uint8_t> data;
+        iff::image_metadata metadata{};
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void run();
+
+    // pushes a kept frame again, called without the lock; `frame` is the repeat thread's slot
+    void repeat(const slot& frame, double timestamp_rate);
+
+    const import_target& importer_;
+    const std::string stream_id_;
+    const std::chrono::steady_clock::duration period_;
+    std::chrono::steady_clock::time_point next_due_; // export callback only
+
+    // slots_[back_] is written by `keep()`, slots_[front_] read by the repeat thread
+    slot slots_[3];
+    size_t back_ = 0;
+    size_t front_ = 1;
+    std::chrono::steady_clock::time_point previous_arrival_; // `keep()` only
+    uint64_t previous_timestamp_ = 0;
+    double estimated_rate_ = 0.0;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    bool idle_ = false;
+    size_t middle_ = 2; // newest kept frame when `fresh_`
+    bool fresh_ = false;
+    bool kept_ = false; // a frame can be repeated
+    std::chrono::steady_clock::time_point next_repeat_;
+    double timestamp_rate_ = 0.0; // timestamp units per second
+    std::thread thread_;
+
+    async_logger& logger_;
+    async_logger::site repeat_log_;
+};
@@ -0,0 +1,368 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_scaler.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "simd.hpp"
+
+void frame_scaler::scale(const frame_view& source, const frame_view& destination, stripe_pool& pool)
+{
+    prepare(source, destination, pool);
+    pool.run(destination.height, [&](uint32_t begin, uint32_t end)
+    {
+        auto& sums = scratch_[stripe_pool::slot()];
+        for(uint32_t y = begin; y < end; ++y)
+        {
+            if(factor_ != 0)
+            {
+                reduce_row(source, destination, sums.data(), y);
+            }
+            else
+            {
+                resample_row(source, destination, sums.data(), y);
+            }
+        }
+    });
+}
+
+frame_scaler::axis frame_scaler::make_axis(method method, uint32_t source, uint32_t destination)
+{
+    axis result;
+    const double ratio = double(source) / destination;
+    std::vector<std::vector<std::pair<uint32_t, double>>> all(destination);
+    for(uint32_t i = 0; i < destination; ++i)
+    {
+        auto& pixel = all[i];
+        if(method == method::area && ratio > 1.0)
+        {
+            const double begin = i * ratio;
+            const double end = (i + 1) * ratio;
+            for(auto j = static_cast<uint32_t>(begin); j < source && j < end; ++j)
+            {
+                const double overlap = std::min(end, j + 1.0) - std::max(begin, double(j));
+                if(overlap > 0.0)
+                {
+                    pixel.emplace_back(j, overlap / ratio);
+                }
+            }
+        }
+        else
+        {
+            // also used for upscaling in `area` mode, where each destination pixel covers at most two source pixels
+            const double centre = std::clamp((i + 0.5) * ratio - 0.5, 0.0, double(source - 1));
+            const auto j = static_cast<uint32_t>(centre);
+            const double fraction = method == method::area ? std::round(centre - j) : centre - j;
+            pixel.emplace_back(j, 1.0 - fraction);
+            if(j + 1 < source)
+            {
+                pixel.emplace_back(j + 1, fraction);
+            }
+        }
+        result.taps = std::max(result.taps, static_cast<uint32_t>(pixel.size()));
+    }
+    result.first.resize(destination);
+    result.weights.assign(size_t(destination) * result.taps, 0);
+    for(uint32_t i = 0; i < destination; ++i)
+    {
+        const auto& pixel = all[i];
+        result.first[i] = std::min(pixel.front().first, source - result.taps);
+        uint16_t* const weights = result.weights.data() + size_t(i) * result.taps;
+        int32_t total = 0;
+        size_t largest = 0;
+        for(const auto& [j, weight] : pixel)
+        {
+            const auto tap = j - result.first[i];
+            weights[tap] = static_cast<uint16_t>(weight * 256.0 + 0.5);
+            total += weights[tap];
+            largest = weights[tap] > weights[largest] ? tap : largest;
+        }
+        weights[largest] = static_cast<uint16_t>(weights[largest] + 256 - total);
+    }
+    return result;
+}
+
+void frame_scaler::prepare(const frame_view& source, const frame_view& destination, const stripe_pool& pool)
+{
+    if(source.width == source_width_ && source.height == source_height_ && source.channels == channels_
+       && destination.width == destination_width_ && destination.height == destination_height_ && scratch_.size() == pool.concurrency())
+    {
+        return;
+    }
+    source_width_ = source.width;
+    source_height_ = source.height;
+    destination_width_ = destination.width;
+    destination_height_ = destination.height;
+    channels_ = source.channels;
+    factor_ = 0;
+    for(uint32_t factor : {2u, 4u})
+    {
+        if(method_ == method::area && source.width == destination.width * factor && source.height == destination.height * factor)
+        {
+            factor_ = factor;
+        }
+    }
+    if(factor_ == 0)
+    {
+        columns_ = make_axis(method_, source.width, destination.width);
+        rows_ = make_axis(method_, source.height, destination.height);
+    }
+    scratch_.resize(pool.concurrency());
+    for(auto& sums : scratch_)
+    {
+        sums.assign(source.row_size() + 1, 0); // 4-lane loads of the last 3-byte pixel read one past the row
+    }
+}
+
+void frame_scaler::resample_row(const frame_view& source, const frame_view& destination, uint16_t* sums, uint32_t y) const noexcept
+{
+    const auto row_size = source.row_size();
+    const auto channels = channels_;
+    std::fill(sums, sums + row_size, 0);
+    for(uint32_t tap = 0; tap < rows_.taps; ++tap)
+    {
+        const uint16_t weight = rows_.weights[size_t(y) * rows_.taps + tap];
+        if(weight == 0)
+        {
+            continue;
+        }
+        const uint8_t* const row = source.row(rows_.first[y] + tap);
+        for(size_t i = 0; i < row_size; ++i)
+        {
+            sums[i] = static_cast<uint16_t>(sums[i] + weight * row[i]);
+        }
+    }
+    const auto output = destination.row(y);
+    const auto width = destination.width;
+    // bilinear and area scaling by up to 2x need at most 2 or 3 taps, which then fully unroll
+    switch(channels * 100 + std::min(columns_.taps, 4u))
+    {
+    case 102:
+        resample_columns<1, 2>(sums, output, width);
+        break;
+    case 103:
+        resample_columns<1, 3>(sums, output, width);
+        break;
+    case 302:
+        resample_columns<3, 2>(sums, output, width);
+        break;
+    case 303:
+        resample_columns<3, 3>(sums, output, width);
+        break;
+    case 402:
+        resample_columns<4, 2>(sums, output, width);
+        break;
+    case 403:
+        resample_columns<4, 3>(sums, output, width);
+        break;
+    default:
+        resample_columns<0, 0>(sums, output, width);
+        break;
+    }
+}
+
+template<uint32_t Channels, uint32_t Taps>
+void frame_scaler::resample_columns(const uint16_t* sums, uint8_t* output, uint32_t width) const noexcept
+{
+    // locals, since stores to `output` may alias members
+    const auto channels = Channels != 0 ? Channels : channels_;
+    const auto taps = Taps != 0 ? Taps : columns_.taps;
+    const uint16_t* const all_weights = columns_.weights.data();
+    const uint32_t* const first = columns_.first.data();
+    uint32_t x = 0;
+    if constexpr(Channels != 1)
+    {
+        x = resample_pixels<Taps>(sums, output, width, channels, taps);
+    }
+    for(; x < width; ++x)
+    {
+        const uint16_t* const weights = all_weights + size_t(x) * taps;
+        const uint16_t* const pixels = sums + size_t(first[x]) * channels;
+        uint32_t values[4] = {1u << 15, 1u << 15, 1u << 15, 1u << 15};
+        for(uint32_t tap = 0; tap < taps; ++tap)
+        {
+            for(uint32_t c = 0; c < channels; ++c)
+            {
+                values[c] += uint32_t(weights[tap]) * pixels[tap * channels + c];
+            }
+        }
+        for(uint32_t c = 0; c < channels; ++c)
+        {
+            output[x * channels + c] = static_cast<uint8_t>(values[c] >> 16);
+        }
+    }
+}
+
+void frame_scaler::reduce_row(const frame_view& source, const frame_view& destination, uint16_t* sums, uint32_t y) const noexcept
+{
+    const auto row_size = source.row_size();
+    const auto channels = channels_;
+    const auto factor = factor_;
+    const auto shift = factor == 2 ? 2u : 4u;
+    std::fill(sums, sums + row_size, 0);
+    for(uint32_t k = 0; k < factor; ++k)
+    {
+        const uint8_t* const row = source.row(y * factor + k);
+        for(size_t i = 0; i < row_size; ++i)
+        {
+            sums[i] = static_cast<uint16_t>(sums[i] + row[i]);
+        }
+    }
+    uint8_t* const output = destination.row(y);
+    const auto output_size = destination.row_size();
+    const auto step = size_t(factor) * channels;
+    const auto reduced = reduce_pixels(sums, output, destination.width, channels, factor);
+    for(size_t i = reduced * channels, j = reduced * step; i < output_size; i += channels, j += step)
+    {
+        for(uint32_t c = 0; c < channels; ++c)
+        {
+            uint32_t value = 1u << (shift - 1);
+            for(uint32_t k = 0; k < factor; ++k)
+            {
+                value += sums[j + k * channels + c];
+            }
+            output[i + c] = static_cast<uint8_t>(value >> shift);
+        }
+    }
+}
+
+template<uint32_t Taps>
+uint32_t frame_scaler::resample_pixels([[maybe_unused]] const uint16_t* sums, [[maybe_unused]] uint8_t* output, [[maybe_unused]] uint32_t width,
+                         uint32_t channels, [[maybe_unused]] uint32_t taps) const noexcept
+{
+    if(channels != 3 && channels != 4)
+    {
+        return 0;
+    }
+    uint32_t x = 0;
+#if defined(IFF_SSE2) || defined(IFF_NEON)
+    const uint16_t* const all_weights = columns_.weights.data();
+    const uint32_t* const first = columns_.first.data();
+    // 3-byte pixels are stored as 4 bytes, the last one is left to the caller
+    const auto end = channels == 4 ? width : width - 1;
+    for(; x < end; ++x)
+    {
+        const uint16_t* const weights = all_weights + size_t(x) * taps;
+        const uint16_t* const pixels = sums + size_t(first[x]) * channels;
+#if defined(IFF_SSE2)
+        auto sum = _mm_set1_epi32(1 << 15);
+        for(uint32_t tap = 0; tap < (Taps != 0 ? Taps : taps); ++tap)
+        {
+            const auto p = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pixels + tap * channels));
+            const auto weight = _mm_set1_epi16(static_cast<int16_t>(weights[tap]));
+            sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(_mm_mullo_epi16(p, weight), _mm_mulhi_epu16(p, weight)));
+        }
+        sum = _mm_srli_epi32(sum, 16);
+        const int32_t value = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(sum, sum), sum));
+#else
+        auto sum = vdupq_n_u32(1 << 15);
+        for(uint32_t tap = 0; tap < (Taps != 0 ? Taps : taps); ++tap)
+        {
+            sum = vmlal_n_u16(sum, vld1_u16(pixels + tap * channels), weights[tap]);
+        }
+        const auto narrow = vshrn_n_u32(sum, 16);
+        const uint32_t value = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(narrow, narrow))), 0);
+#endif
+        std::memcpy(output + x * channels, &value, sizeof(value));
+    }
+#endif
+    return x;
+}
+
+uint32_t frame_scaler::reduce_pixels([[maybe_unused]] const uint16_t* sums, [[maybe_unused]] uint8_t* output, [[maybe_unused]] uint32_t width,
+                              [[maybe_unused]] uint32_t channels, [[maybe_unused]] uint32_t factor) noexcept
+{
+    uint32_t x = 0;
+#if defined(IFF_SSE2) || defined(IFF_NEON)
+    const auto shift = factor == 2 ? 2 : 4;
+#if defined(IFF_SSE2)
+    const auto round = _mm_set1_epi16(static_cast<int16_t>(1 << (shift - 1)));
+    const auto count = _mm_cvtsi32_si128(shift);
+    const auto load = [](const uint16_t* p){ return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); };
+    const auto ones = _mm_set1_epi16(1);
+    // sums of adjacent lanes, at most 16 * 255 so the signed arithmetic is exact
+    const auto pairs = [&](__m128i a, __m128i b){ return _mm_packs_epi32(_mm_madd_epi16(a, ones), _mm_madd_epi16(b, ones)); };
+#else
+    const auto count = vdupq_n_s16(static_cast<int16_t>(-shift)); // rounding right shift
+    const auto pairs = [](uint16x8_t a, uint16x8_t b)
+    {
+        return vcombine_u16(vpadd_u16(vget_low_u16(a), vget_high_u16(a)), vpadd_u16(vget_low_u16(b), vget_high_u16(b)));
+    };
+#endif
+    if(channels == 1)
+    {
+        for(; x + 8 <= width; x += 8)
+        {
+            const uint16_t* const p = sums + size_t(x) * factor;
+#if defined(IFF_SSE2)
+            auto v = pairs(load(p), load(p + 8));
+            if(factor == 4)
+            {
+                v = pairs(v, pairs(load(p + 16), load(p + 24)));
+            }
+            v = _mm_srl_epi16(_mm_add_epi16(v, round), count);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output + x), _mm_packus_epi16(v, v));
+#else
+            auto v = pairs(vld1q_u16(p), vld1q_u16(p + 8));
+            if(factor == 4)
+            {
+                v = pairs(v, pairs(vld1q_u16(p + 16), vld1q_u16(p + 24)));
+            }
+            vst1_u8(output + x, vmovn_u16(vrshlq_u16(v, count)));
+#endif
+        }
+        return x;
+    }
+    // 3-byte pixels are stored as 4 bytes, the last one is left to the caller
+    const auto end = channels == 4 ? width : width - 1;
+    for(; x < end; ++x)
+    {
+        const uint16_t* const p = sums + size_t(x) * factor * channels;
+#if defined(IFF_SSE2)
+        auto v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+        for(uint32_t k = 1; k < factor; ++k)
+        {
+            v = _mm_add_epi16(v, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + k * channels)));
+        }
+        v = _mm_srl_epi16(_mm_add_epi16(v, round), count);
+        const int32_t value = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+#else
+        auto v = vld1_u16(p);
+        for(uint32_t k = 1; k < factor; ++k)
+        {
+            v = vadd_u16(v, vld1_u16(p + k * channels));
+        }
+        v = vrshl_u16(v, vget_low_s16(count));
+        const uint32_t value = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(v, v))), 0);
+#endif
+        std::memcpy(output + x * channels, &value, sizeof(value));
+    }
+#endif
+    return x;
+}
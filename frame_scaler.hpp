@@ -0,0 +1,103 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Resamples a frame into one of another size with the same pixel format.
+// `area` averages all source pixels covered by a destination pixel and suits
+// downscaling by any ratio; `bilinear` interpolates between the two nearest
+// source pixels in each direction. Weights are 8-bit fixed point, precomputed
+// per destination column and row when the geometry changes. Each destination
+// row is a vertical pass over whole source rows in 16-bit lanes, which
+// compilers vectorize, followed by a horizontal pass over the narrower result,
+// which they do not (each pixel reads its own source position), so it uses
+// SSE2 or NEON with a pixel per vector (8 per vector for `Mono8` reductions);
+// exact 2x and 4x area reductions use plain sums and a shift instead.
+class frame_scaler
+{
+public:
+    enum class method
+    {
+        area,
+        bilinear
+    };
+
+    explicit frame_scaler(method method)
+        : method_(method)
+    {
+    }
+
+    void scale(const frame_view& source, const frame_view& destination, stripe_pool& pool);
+
+private:
+    // source pixels contributing to each destination pixel along one axis
+    struct axis
+    {
+        std::vector<uint32_t> first;
+        std::vector<uint16_t> weights; // `taps` per destination pixel, summing to 256
+        uint32_t taps = 0;
+    };
+
+    static axis make_axis(method method, uint32_t source, uint32_t destination);
+
+    void prepare(const frame_view& source, const frame_view& destination, const stripe_pool& pool);
+
+    void resample_row(const frame_view& source, const frame_view& destination, uint16_t* sums, uint32_t y) const noexcept;
+
+    // `Channels` and `Taps` of 0 are read from members instead
+    template<uint32_t Channels, uint32_t Taps>
+    void resample_columns(const uint16_t* sums, uint8_t* output, uint32_t width) const noexcept;
+
+    void reduce_row(const frame_view& source, const frame_view& destination, uint16_t* sums, uint32_t y) const noexcept;
+
+    // Horizontal pass of `resample_columns()` for 3- and 4-byte pixels, a pixel
+    // per vector; returns how many of the `width` pixels it wrote.
+    template<uint32_t Taps>
+    uint32_t resample_pixels([[maybe_unused]] const uint16_t* sums, [[maybe_unused]] uint8_t* output, [[maybe_unused]] uint32_t width,
+                             uint32_t channels, [[maybe_unused]] uint32_t taps) const noexcept;
+
+    // Horizontal pass of `reduce_row()`, a pixel per vector for 3- and 4-byte
+    // pixels and 8 per vector for 1-byte ones; returns how many of the
+    // `width` pixels it wrote.
+    static uint32_t reduce_pixels([[maybe_unused]] const uint16_t* sums, [[maybe_unused]] uint8_t* output, [[maybe_unused]] uint32_t width,
+                                  [[maybe_unused]] uint32_t channels, [[maybe_unused]] uint32_t factor) noexcept;
+
+    const method method_;
+    uint32_t source_width_ = 0;
+    uint32_t source_height_ = 0;
+    uint32_t destination_width_ = 0;
+    uint32_t destination_height_ = 0;
+    uint32_t channels_ = 0;
+    uint32_t factor_ = 0; // 2 or 4 for exact area reductions
+    axis columns_;
+    axis rows_;
+    std::vector<std::vector<uint16_t>> scratch_; // vertical sums of a source row per thread
+};
@@ -0,0 +1,135 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "frame_synchronizer.hpp"
+
+// std
+#include <algorithm>
+#include <sstream>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+frame_synchronizer::frame_synchronizer(synchronizer_config&& config, std::vector<stream*> streams)
+    : id(config.id)
+    , members(std::move(streams))
+    , tolerance_(config.tolerance)
+    , window_(config.window)
+    , rings_(members.size())
+    , staged_(size_t(config.window) * members.size())
+    , unmatched_(members.size(), 0)
+{
+    for(auto& ring : rings_)
+    {
+        ring.entries.resize(window_);
+    }
+}
+
+void frame_synchronizer::offer(size_t member, import_buffer&& buffer, release_function release)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& ring = rings_[member];
+    if(ring.count == window_)
+    {
+        ring.pop().reset();
+        ++unmatched_[member];
+    }
+    auto& added = ring.entries[(ring.head + ring.count++) % window_];
+    added.timestamp = buffer.metadata().timestamp;
+    added.arrival = std::chrono::steady_clock::now();
+    added.buffer = std::move(buffer);
+    if(std::any_of(rings_.begin(), rings_.end(), [](const frame_ring& r){ return r.count == 0; }))
+    {
+        return;
+    }
+
+    // taken before the state lock is released, so sets leave in the order they were matched
+    std::scoped_lock<std::mutex> release_lock(release_mutex_);
+    size_t released = 0;
+    while(match(staged_.data() + released))
+    {
+        released += members.size();
+    }
+    lock.unlock();
+    for(size_t i = 0; i < released; ++i)
+    {
+        release(i % members.size(), staged_[i]);
+        staged_[i].reset();
+    }
+}
+
+bool frame_synchronizer::match(import_buffer* out)
+{
+    while(true)
+    {
+        size_t oldest = 0;
+        size_t newest = 0;
+        for(size_t i = 0; i < rings_.size(); ++i)
+        {
+            if(rings_[i].count == 0)
+            {
+                return false;
+            }
+            if(rings_[i].front().timestamp < rings_[oldest].front().timestamp)
+            {
+                oldest = i;
+            }
+            if(rings_[i].front().timestamp > rings_[newest].front().timestamp)
+            {
+                newest = i;
+            }
+        }
+        if(rings_[newest].front().timestamp - rings_[oldest].front().timestamp > tolerance_)
+        {
+            // frames of `newest` only get later, so the oldest frame can never be matched
+            rings_[oldest].pop().reset();
+            ++unmatched_[oldest];
+            continue;
+        }
+        auto first_arrival = rings_[0].front().arrival;
+        for(size_t i = 0; i < rings_.size(); ++i)
+        {
+            first_arrival = std::min(first_arrival, rings_[i].front().arrival);
+            out[i] = rings_[i].pop();
+        }
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - first_arrival);
+        latency_total_ += latency;
+        latency_max_ = std::max(latency_max_, latency);
+        ++sets_;
+        return true;
+    }
+}
+
+void frame_synchronizer::log_statistics() const
+{
+    std::ostringstream message;
+    message << "Synchronizer `" << id << "`: " << sets() << " sets, pairing latency mean "
+            << mean_latency().count() << " us, max " << max_latency().count() << " us, unmatched frames:";
+    for(size_t i = 0; i < members.size(); ++i)
+    {
+        message << (i == 0 ? " " : ", ") << members[i]->id << " " << unmatched(i);
+    }
+    iff::log(iff::log_level::info, "imagefiltercpp", message.str());
+}
@@ -0,0 +1,130 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "import_buffer.hpp"
+#include "stream.hpp"
+#include "stream_config.hpp"
+#include "stripe_pool.hpp"
+
+// Pairs processed frames of several streams by capture timestamp. Each stream
+// offers its frames in order; they wait in a ring of `window` frames per
+// stream until every stream has one within `tolerance` of the others, and
+// the set is then released together. A frame that can no longer be part of a
+// set (older than the newest waiting frame of another stream by more than the
+// tolerance), or that falls out of a full window, is dropped as unmatched.
+// Sets are released in order by the thread that completed them, outside of
+// the lock that offering threads take.
+class frame_synchronizer
+{
+public:
+    // receives the frames of a set in member order
+    using release_function = function_ref<void(size_t member, import_buffer& buffer)>;
+
+    frame_synchronizer(synchronizer_config&& config, std::vector<stream*> streams);
+
+    frame_synchronizer(const frame_synchronizer&) = delete;
+    frame_synchronizer& operator=(const frame_synchronizer&) = delete;
+
+    void offer(size_t member, import_buffer&& buffer, release_function release);
+
+    const std::string id;
+    const std::vector<stream*> members;
+
+    // statistics, consistent once no more frames are offered
+    uint64_t sets() const noexcept
+    {
+        return sets_;
+    }
+
+    uint64_t unmatched(size_t member) const noexcept
+    {
+        return unmatched_[member];
+    }
+
+    // wall-clock time from the arrival of the first frame of a set to its release
+    std::chrono::microseconds mean_latency() const noexcept
+    {
+        return std::chrono::microseconds(sets_ != 0 ? latency_total_.count() / int64_t(sets_) : 0);
+    }
+
+    std::chrono::microseconds max_latency() const noexcept
+    {
+        return latency_max_;
+    }
+
+    void log_statistics() const;
+
+private:
+    struct entry
+    {
+        import_buffer buffer;
+        uint64_t timestamp = 0;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    struct frame_ring
+    {
+        std::vector<entry> entries;
+        size_t head = 0;
+        size_t count = 0;
+
+        entry& front() noexcept
+        {
+            return entries[head];
+        }
+
+        import_buffer pop() noexcept
+        {
+            auto buffer = std::move(entries[head].buffer);
+            head = (head + 1) % entries.size();
+            --count;
+            return buffer;
+        }
+    };
+
+    // moves the next set into `out` if the oldest frames allow one
+    bool match(import_buffer* out);
+
+    const uint64_t tolerance_;
+    const size_t window_;
+    std::mutex mutex_;
+    std::vector<frame_ring> rings_;
+    std::mutex release_mutex_;
+    std::vector<import_buffer> staged_; // sets being released, guarded by `release_mutex_`
+
+    uint64_t sets_ = 0;
+    std::vector<uint64_t> unmatched_;
+    std::chrono::microseconds latency_total_{0};
+    std::chrono::microseconds latency_max_{0};
+};
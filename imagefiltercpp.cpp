@@ -23,23 +23,22 @@
  */
 
 // std
-#include <condition_variable>
-#include <cstdint>
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
-#include <cstring>
 #include <exception>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
+#include <vector>
 
 // json
 #include <nlohmann/json.hpp>
@@ -48,6 +47,17 @@
 #include <iffwrapper.hpp>
 namespace iff = iffwrapper;
 
+#include "async_logger.hpp"
+#include "frame_path.hpp"
+#include "frame_synchronizer.hpp"
+#include "import_buffer.hpp"
+#include "mosaic.hpp"
+#include "perf_counters.hpp"
+#include "stream.hpp"
+#include "stream_config.hpp"
+#include "stripe_pool.hpp"
+#include "tracer.hpp"
+
 #ifdef __aarch64__
 #pragma message("Make sure that configuration file uses YV12 output format instead of default NV12")
 #endif
@@ -55,6 +65,49 @@ namespace iff = iffwrapper;
 
 constexpr char CONFIG_FILENAME[] = "imagefiltercpp.json";
 
+// Rate-limited log sites of the elements of one chain, including elements
+// nested in processors (`processor/element`), created up front so that
+// reporting an error does not allocate.
+class element_error_logs
+{
+public:
+    element_error_logs(async_logger& logger, const nlohmann::json& chain_config)
+        : other_(logger, "Chain `" + chain_config.value("id", std::string()) + "` element error")
+    {
+        add(logger, chain_config, chain_config.value("id", std::string()), "");
+    }
+
+    async_logger::site& site(std::string_view element_name)
+    {
+        auto it = sites_.find(element_name);
+        if(it == sites_.end())
+        {
+            // an unknown nested element is counted with its processor
+            it = sites_.find(element_name.substr(0, element_name.find('/')));
+        }
+        return it != sites_.end() ? *it->second : other_;
+    }
+
+private:
+    void add(async_logger& logger, const nlohmann::json& config, const std::string& chain_id, const std::string& prefix)
+    {
+        const auto it_elements = config.find("elements");
+        if(it_elements == config.end() || !it_elements->is_array())
+        {
+            return;
+        }
+        for(const auto& element : *it_elements)
+        {
+            const auto name = prefix + element.value("id", std::string());
+            sites_.emplace(name, std::make_unique<async_logger::site>(logger, "Chain `" + chain_id + "` element `" + name + "` error"));
+            add(logger, element, chain_id, name + "/");
+        }
+    }
+
+    async_logger::site other_;
+    std::map<std::string, std::unique_ptr<async_logger::site>, std::less<>> sites_;
+};
+
 int main()
 {
     nlohmann::json config;
@@ -89,113 +142,203 @@ int main()
         std::cerr << "Invalid configuration provided: missing `IFF` section\n";
         return EXIT_FAILURE;
     }
+    // filters log through it, so it is created before them and started once the SDK is initialized
+    async_logger logger;
+    std::vector<stream_config> stream_configs;
+    std::vector<mosaic_config> mosaic_configs;
+    std::vector<synchronizer_config> synchronizer_configs;
+    // one core is left to the SDK's own threads (capture, GPU processing, encoding)
+    const size_t automatic_threads = std::max(1u, std::thread::hardware_concurrency()) - (std::thread::hardware_concurrency() > 1 ? 1 : 0);
+    size_t processing_threads = automatic_threads;
+    std::unique_ptr<tracer> trace;
+    std::unique_ptr<perf_counters> counters;
+    try
+    {
+        stream_configs = parse_stream_configs(config, *it_chains, logger);
+        mosaic_configs = parse_mosaic_configs(config, *it_chains, stream_configs);
+        synchronizer_configs = parse_synchronizer_configs(config, stream_configs);
+        const auto it_processing = config.find("processing");
+        if(it_processing != config.end())
+        {
+            processing_threads = it_processing->value("threads", size_t(0));
+            if(processing_threads == 0)
+            {
+                processing_threads = automatic_threads;
+            }
+            // `true` traces with the defaults, `false` or `null` is the same as leaving it out
+            const auto it_trace = it_processing->find("trace");
+            if(it_trace != it_processing->end() && !it_trace->is_null() && !it_trace->is_boolean() && !it_trace->is_object())
+            {
+                throw std::runtime_error("`processing.trace` must be a boolean or an object");
+            }
+            if(it_trace != it_processing->end() && (it_trace->is_object() || (it_trace->is_boolean() && it_trace->get<bool>())))
+            {
+                const auto settings = it_trace->is_object() ? *it_trace : nlohmann::json::object();
+                const auto capacity = settings.value("capacity", size_t(65536));
+                if(capacity < 1024 || capacity > (size_t(1) << 24))
+                {
+                    throw std::runtime_error("`processing.trace.capacity` must be in [1024, 16777216]");
+                }
+                trace = std::make_unique<tracer>(settings.value("file", "imagefiltercpp_trace.json"), capacity);
+            }
+            if(it_processing->value("perf_counters", false))
+            {
+                counters = std::make_unique<perf_counters>();
+            }
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << "Invalid configuration provided: " << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
 
     iff::initialize(it_iff->dump());
 
-    std::map<std::string, std::shared_ptr<iff::chain>> chains;
+    // one rate limit per chain element, so that an error storm of one element does not hide errors of the others
+    std::vector<std::unique_ptr<element_error_logs>> chain_error_logs;
     for(const auto& chain_config : *it_chains)
     {
+        chain_error_logs.push_back(std::make_unique<element_error_logs>(logger, chain_config));
+    }
+    logger.start();
+
+    std::map<std::string, std::shared_ptr<iff::chain>> chains;
+    for(size_t i = 0; i < it_chains->size(); ++i)
+    {
+        const auto& chain_config = (*it_chains)[i];
         auto chain = std::make_shared<iff::chain>(chain_config.dump(),
-                                                  [](const std::string& element_name, int error_code)
+                                                  [&logger, &error_logs = *chain_error_logs[i]](const std::string& element_name, int error_code)
                                                   {
-                                                      std::ostringstream message;
-                                                      message << "Chain element `" << element_name << "` reported an error: " << error_code;
-                                                      iff::log(iff::log_level::error, "imagefiltercpp", message.str());
+                                                      logger.log(error_logs.site(element_name), iff::log_level::error, "Chain element `%s` reported an error: %d", element_name.c_str(), error_code);
                                                   });
         chains.emplace(chain_config["id"].get<std::string>(), std::move(chain));
     }
 
-    std::mutex mutex;
-    std::condition_variable cv;
-    std::queue<std::pair<void*, iff::image_metadata>> processing_queue;
-    bool stop_processing = false;
-    const auto process = [&]()
+    std::vector<std::unique_ptr<stream>> streams;
+    for(auto& stream_config : stream_configs)
+    {
+        streams.push_back(std::make_unique<stream>(std::move(stream_config), chains, logger));
+    }
+    std::vector<std::unique_ptr<mosaic>> mosaics;
+    for(auto& mosaic_config : mosaic_configs)
     {
-        std::unique_lock<std::mutex> lock(mutex);
-        while(true)
+        auto& m = *mosaics.emplace_back(std::make_unique<mosaic>(std::move(mosaic_config), chains, logger));
+        for(size_t i = 0; i < m.tile_streams.size(); ++i)
         {
-            while(!processing_queue.empty())
+            for(const auto& stream : streams)
             {
-                const auto [buffer, metadata] = processing_queue.front();
-                processing_queue.pop();
-                lock.unlock();
-
-                // draw crosshair
-                const auto char_ptr = reinterpret_cast<uint8_t*>(buffer);
-                constexpr size_t bpp = 3;
-                const auto stride = metadata.width * bpp + metadata.padding;
-                for(uint32_t y = metadata.height / 2 - 100; y < metadata.height / 2 + 100; ++y)
+                if(stream->id == m.tile_streams[i])
                 {
-                    for(uint32_t x = metadata.width / 2 - 2; x < metadata.width / 2 + 2; ++x)
-                    {
-                        char_ptr[y * stride + x * bpp + 0] = 0;
-                        char_ptr[y * stride + x * bpp + 1] = 0;
-                        char_ptr[y * stride + x * bpp + 2] = 255;
-                    }
+                    stream->mosaic_tiles.push_back(&m.at(i));
                 }
-                for(uint32_t x = metadata.width / 2 - 100; x < metadata.width / 2 + 100; ++x)
-                {
-                    for(uint32_t y = metadata.height / 2 - 2; y < metadata.height / 2 + 2; ++y)
-                    {
-                        char_ptr[y * stride + x * bpp + 0] = 0;
-                        char_ptr[y * stride + x * bpp + 1] = 0;
-                        char_ptr[y * stride + x * bpp + 2] = 255;
-                    }
-                }
-
-                chains["import"]->push_import_buffer("importer", buffer, metadata);
-                lock.lock();
             }
-            if(stop_processing)
-            {
-                return;
-            }
-            cv.wait(lock);
         }
-    };
-    auto processing_thread = std::thread([&](){ process(); });
-
-    chains["export"]->set_export_callback("exporter",
-                                          [&](const void* const data, const size_t size, const iff::image_metadata metadata)
-                                          {
-                                              size_t buffer_size;
-                                              const auto buffer = chains["import"]->get_import_buffer("importer", &buffer_size);
-                                              if(buffer != nullptr)
-                                              {
-                                                  if(buffer_size >= size)
-                                                  {
-                                                      std::memcpy(buffer, data, size);
-                                                      {
-                                                          std::scoped_lock<std::mutex> lock(mutex);
-                                                          processing_queue.emplace(buffer, metadata);
-                                                      }
-                                                      cv.notify_all();
-                                                  }
-                                                  else
-                                                  {
-                                                      std::ostringstream message;
-                                                      message << "Got import buffer size less than export buffer size (" << buffer_size << " < " << size << ")";
-                                                      iff::log(iff::log_level::error, "imagefiltercpp", message.str());
-                                                      chains["import"]->release_buffer("importer", buffer);
-                                                  }
-                                              }
-                                          });
+    }
+    std::vector<std::unique_ptr<frame_synchronizer>> synchronizers;
+    for(auto& synchronizer_config : synchronizer_configs)
+    {
+        std::vector<stream*> members;
+        for(const auto& id : synchronizer_config.streams)
+        {
+            members.push_back(std::find_if(streams.begin(), streams.end(), [&](const auto& s){ return s->id == id; })->get());
+        }
+        auto& synchronizer = *synchronizers.emplace_back(std::make_unique<frame_synchronizer>(std::move(synchronizer_config), members));
+        for(size_t i = 0; i < members.size(); ++i)
+        {
+            members[i]->synchronizer = &synchronizer;
+            members[i]->synchronizer_member = i;
+        }
+    }
+
+    stripe_pool pool(processing_threads);
+    frame_path path(pool, logger);
+    for(const auto& stream_ptr : streams)
+    {
+        auto& stream = *stream_ptr;
+        stream.processing_thread = std::thread([&](){ path.process(stream); });
 
-    chains["export"]->execute(nlohmann::json{{"exporter", {{"command", "on"}}}}.dump(), [](const std::string&){});
+        stream.export_chain->set_export_callback(stream.exporter,
+                                                 [&](const void* const data, const size_t size, const iff::image_metadata metadata)
+                                                 {
+                                                     path.receive(stream, data, size, metadata);
+                                                 });
+    }
+
+    if(trace)
+    {
+        trace->start();
+    }
+    if(counters)
+    {
+        counters->start();
+    }
+    for(const auto& m : mosaics)
+    {
+        m->start();
+    }
+    for(const auto& stream : streams)
+    {
+        stream->start_stages();
+    }
+    for(const auto& stream : streams)
+    {
+        stream->export_chain->execute(nlohmann::json{{stream->exporter, {{"command", "on"}}}}.dump(), [](const std::string&){});
+    }
 
     iff::log(iff::log_level::info, "imagefiltercpp", "Press Enter to terminate the program");
     std::getchar();
 
-    chains["export"]->execute(nlohmann::json{{"exporter", {{"command", "off"}}}}.dump(), [](const std::string&){});
+    for(const auto& stream : streams)
+    {
+        stream->export_chain->execute(nlohmann::json{{stream->exporter, {{"command", "off"}}}}.dump(), [](const std::string&){});
+    }
+    for(const auto& stream : streams)
+    {
+        stream->stop();
+    }
+    for(const auto& stream : streams)
+    {
+        // after all processing threads, as synchronizers release frames of other streams too
+        stream->stop_stages();
+        stream->log_statistics();
+    }
+    for(const auto& m : mosaics)
+    {
+        m->stop();
+        m->log_statistics();
+    }
+    for(const auto& synchronizer : synchronizers)
+    {
+        synchronizer->log_statistics();
+    }
+
+    if(trace)
     {
-        std::scoped_lock<std::mutex> lock(mutex);
-        stop_processing = true;
+        // spans refer to stream ids and filter names
+        trace->stop();
+    }
+    if(counters)
+    {
+        // so do the counted stages
+        counters->stop();
+    }
+
+    // return buffers that were still queued or waiting for a match when processing stopped
+    synchronizers.clear();
+    mosaics.clear();
+    streams.clear();
+    if(import_buffer::outstanding() != 0)
+    {
+        std::ostringstream message;
+        message << "Import buffers leaked: " << import_buffer::outstanding();
+        iff::log(iff::log_level::warning, "imagefiltercpp", message.str());
     }
-    cv.notify_all();
-    processing_thread.join();
 
     chains.clear();
 
+    logger.stop();
+
     iff::finalize();
 
     return EXIT_SUCCESS;
@@ -0,0 +1,112 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "import_buffer.hpp"
+
+#include "allocation_check.hpp"
+#include "perf_counters.hpp"
+#include "probes.hpp"
+#include "tracer.hpp"
+
+import_buffer& import_buffer::operator=(import_buffer&& other) noexcept
+{
+    if(this != &other)
+    {
+        reset();
+        target_ = std::exchange(other.target_, nullptr);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        metadata_ = other.metadata_;
+    }
+    return *this;
+}
+
+import_buffer import_buffer::acquire(const import_target& target)
+{
+    import_buffer result;
+    size_t size = 0;
+    const allocation_check::exempt sdk_call;
+    const auto data = target.chain->get_import_buffer(target.element, &size);
+    if(data != nullptr)
+    {
+        result.target_ = &target;
+        result.data_ = data;
+        result.size_ = size;
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void import_buffer::push()
+{
+    if(data_ != nullptr)
+    {
+        const tracer::span trace("push", tracer::context{tracer::current().stream, metadata_.frame_number});
+        const perf_counters::stage counted("push", uint64_t(metadata_.width) * metadata_.height);
+        IFF_PROBE5(pushed, tracer::current().stream, metadata_.frame_number, size_, metadata_.timestamp, target_->element.c_str());
+        {
+            // if the SDK throws, the buffer is still ours to release
+            const allocation_check::exempt sdk_call;
+            target_->chain->push_import_buffer(target_->element, data_, metadata_);
+        }
+        target_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+        outstanding_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+void import_buffer::reset() noexcept
+{
+    if(data_ != nullptr)
+    {
+        IFF_PROBE5(released, tracer::current().stream, metadata_.frame_number, size_, metadata_.timestamp, target_->element.c_str());
+        const auto target = std::exchange(target_, nullptr);
+        const auto data = std::exchange(data_, nullptr);
+        size_ = 0;
+        outstanding_.fetch_sub(1, std::memory_order_relaxed);
+        try
+        {
+            const allocation_check::exempt sdk_call;
+            target->chain->release_buffer(target->element, data);
+        }
+        catch(...)
+        {
+        }
+    }
+}
+
+bool frame_queue::push(import_buffer&& buffer, std::chrono::steady_clock::time_point deadline) noexcept
+{
+    if(count_ == slots_.size())
+    {
+        return false;
+    }
+    auto& slot = slots_[(head_ + count_) % slots_.size()];
+    slot.buffer = std::move(buffer);
+    slot.deadline = deadline;
+    slot.queued = std::chrono::steady_clock::now();
+    ++count_;
+    return true;
+}
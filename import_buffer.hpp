@@ -0,0 +1,163 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+struct import_target
+{
+    std::shared_ptr<iff::chain> chain;
+    std::string element;
+};
+
+// Owns a buffer obtained from `get_import_buffer()` together with its metadata.
+// The buffer is handed back to the SDK exactly once: either by `push()` or,
+// on any other path (error, shutdown, exception), by `release_buffer()`.
+class import_buffer
+{
+public:
+    import_buffer() noexcept = default;
+
+    import_buffer(import_buffer&& other) noexcept
+        : target_(std::exchange(other.target_, nullptr))
+        , data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , metadata_(other.metadata_)
+    {
+    }
+
+    import_buffer& operator=(import_buffer&& other) noexcept;
+
+    import_buffer(const import_buffer&) = delete;
+    import_buffer& operator=(const import_buffer&) = delete;
+
+    ~import_buffer()
+    {
+        reset();
+    }
+
+    static import_buffer acquire(const import_target& target);
+
+    // number of import buffers currently held by the application
+    static int64_t outstanding() noexcept
+    {
+        return outstanding_.load(std::memory_order_relaxed);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return data_ != nullptr;
+    }
+
+    uint8_t* data() const noexcept
+    {
+        return static_cast<uint8_t*>(data_);
+    }
+
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    const iff::image_metadata& metadata() const noexcept
+    {
+        return metadata_;
+    }
+
+    void set_metadata(const iff::image_metadata& metadata) noexcept
+    {
+        metadata_ = metadata;
+    }
+
+    void push();
+
+    void reset() noexcept;
+
+private:
+    static inline std::atomic<int64_t> outstanding_{0};
+
+    const import_target* target_ = nullptr;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    iff::image_metadata metadata_{};
+};
+
+// Fixed-capacity FIFO of import buffers with the deadlines of their frames;
+// storage is allocated once, so pushing and popping frames never touches the
+// heap. Not thread-safe.
+class frame_queue
+{
+public:
+    struct entry
+    {
+        import_buffer buffer;
+        std::chrono::steady_clock::time_point deadline;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    explicit frame_queue(size_t capacity)
+        : slots_(capacity)
+    {
+    }
+
+    bool empty() const noexcept
+    {
+        return count_ == 0;
+    }
+
+    bool push(import_buffer&& buffer, std::chrono::steady_clock::time_point deadline) noexcept;
+
+    entry pop() noexcept
+    {
+        auto popped = std::move(slots_[head_]);
+        head_ = (head_ + 1) % slots_.size();
+        --count_;
+        return popped;
+    }
+
+    void clear() noexcept
+    {
+        while(!empty())
+        {
+            pop();
+        }
+    }
+
+private:
+    std::vector<entry> slots_;
+    size_t head_ = 0;
+    size_t count_ = 0;
+};
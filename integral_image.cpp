@@ -0,0 +1,99 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "integral_image.hpp"
+
+// std
+#include <cstring>
+
+void integral_image::compute(const frame_view& frame, stripe_pool& pool)
+{
+    prepare(frame, pool);
+    const auto columns = size_t(width_) + 1;
+    // prefix sums along each row
+    pool.run(height_, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = begin; y < end; ++y)
+        {
+            const auto pixels = frame.row(y);
+            uint8_t* const luma = luma_.data() + size_t(stripe_pool::slot()) * width_;
+            to_luma(pixels, luma, width_, frame.channels);
+            uint32_t* const sums = sums_.data() + (size_t(y) + 1) * columns;
+            uint64_t* const squares = squares_.data() + (size_t(y) + 1) * columns;
+            uint32_t sum = 0;
+            uint64_t square = 0;
+            for(uint32_t x = 0; x < width_; ++x)
+            {
+                sum += luma[x];
+                square += uint32_t(luma[x]) * luma[x];
+                sums[x + 1] = sum;
+                squares[x + 1] = square;
+            }
+        }
+    });
+    // accumulation down the columns, split into column ranges
+    pool.run(static_cast<uint32_t>(columns), [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = 2; y <= height_; ++y)
+        {
+            uint32_t* const sums = sums_.data() + size_t(y) * columns;
+            const uint32_t* const sums_above = sums - columns;
+            uint64_t* const squares = squares_.data() + size_t(y) * columns;
+            const uint64_t* const squares_above = squares - columns;
+            for(uint32_t x = begin; x < end; ++x)
+            {
+                sums[x] += sums_above[x];
+                squares[x] += squares_above[x];
+            }
+        }
+    });
+}
+
+void integral_image::to_luma(const uint8_t* pixels, uint8_t* luma, uint32_t width, uint32_t channels) noexcept
+{
+    if(channels == 1)
+    {
+        std::memcpy(luma, pixels, width);
+        return;
+    }
+    for(uint32_t x = 0; x < width; ++x)
+    {
+        const auto pixel = pixels + size_t(x) * channels;
+        luma[x] = static_cast<uint8_t>((pixel[0] + 2 * pixel[1] + pixel[2]) >> 2);
+    }
+}
+
+void integral_image::prepare(const frame_view& frame, const stripe_pool& pool)
+{
+    if(frame.width == width_ && frame.height == height_)
+    {
+        return;
+    }
+    width_ = frame.width;
+    height_ = frame.height;
+    const auto size = (size_t(width_) + 1) * (size_t(height_) + 1);
+    sums_.assign(size, 0);
+    squares_.assign(size, 0);
+    luma_.assign(size_t(width_) * pool.concurrency(), 0);
+}
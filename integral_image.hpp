@@ -0,0 +1,108 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Summed-area tables of luma and squared luma, computed before the filters run
+// on frames where a filter that requested them reads them (see
+// `filter::reads_integral()`). Afterwards the sum, mean and variance of any
+// rectangle are available in constant time.
+class integral_image
+{
+public:
+    void request() noexcept
+    {
+        requested_ = true;
+    }
+
+    bool requested() const noexcept
+    {
+        return requested_;
+    }
+
+    uint32_t width() const noexcept
+    {
+        return width_;
+    }
+
+    uint32_t height() const noexcept
+    {
+        return height_;
+    }
+
+    void compute(const frame_view& frame, stripe_pool& pool);
+
+    // sum of luma over [x, x + w) x [y, y + h); the rectangle must lie within the frame
+    uint64_t sum(uint32_t x, uint32_t y, uint32_t w, uint32_t h) const noexcept
+    {
+        return rectangle(sums_.data(), x, y, w, h);
+    }
+
+    uint64_t sum_of_squares(uint32_t x, uint32_t y, uint32_t w, uint32_t h) const noexcept
+    {
+        return rectangle(squares_.data(), x, y, w, h);
+    }
+
+    double mean(uint32_t x, uint32_t y, uint32_t w, uint32_t h) const noexcept
+    {
+        return double(sum(x, y, w, h)) / (double(w) * h);
+    }
+
+    double variance(uint32_t x, uint32_t y, uint32_t w, uint32_t h) const noexcept
+    {
+        const double area = double(w) * h;
+        const double mean = double(sum(x, y, w, h)) / area;
+        return std::max(0.0, double(sum_of_squares(x, y, w, h)) / area - mean * mean);
+    }
+
+private:
+    static void to_luma(const uint8_t* pixels, uint8_t* luma, uint32_t width, uint32_t channels) noexcept;
+
+    template<typename T>
+    uint64_t rectangle(const T* table, uint32_t x, uint32_t y, uint32_t w, uint32_t h) const noexcept
+    {
+        const auto columns = size_t(width_) + 1;
+        const auto top = size_t(y) * columns;
+        const auto bottom = (size_t(y) + h) * columns;
+        // unsigned wrap-around of 32-bit sums cancels out as long as the rectangle sum fits
+        return static_cast<T>(table[bottom + x + w] - table[bottom + x] - table[top + x + w] + table[top + x]);
+    }
+
+    void prepare(const frame_view& frame, const stripe_pool& pool);
+
+    bool requested_ = false;
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    std::vector<uint32_t> sums_;    // (width + 1) x (height + 1), first row and column are zero
+    std::vector<uint64_t> squares_;
+    std::vector<uint8_t> luma_;     // one row per stripe pool slot
+};
@@ -0,0 +1,117 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "load_shedder.hpp"
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+load_shedder::load_shedder(const load_shedding_config& config, std::vector<degradation> levels, const std::string& stream_id, async_logger& logger)
+    : levels_(std::move(levels))
+    , budget_(1.0 / config.fps)
+    , high_(config.high)
+    , low_(config.low)
+    , times_(config.window, 0.0)
+    , recovery_(4 * size_t(config.window))
+    , stream_id_(stream_id)
+    , logger_(logger)
+    , change_log_(logger, "Stream `" + stream_id + "` load shedding", std::chrono::nanoseconds(0))
+{
+}
+
+bool load_shedder::skip_frame() noexcept
+{
+    if(!skipping_.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+    skip_next_ = !skip_next_;
+    if(skip_next_)
+    {
+        ++skipped;
+    }
+    return skip_next_;
+}
+
+void load_shedder::record(std::chrono::steady_clock::duration filter_time)
+{
+    const auto time = std::chrono::duration<double>(filter_time).count();
+    total_ += time - times_[next_];
+    times_[next_] = time;
+    next_ = (next_ + 1) % times_.size();
+    ++frames_at_level_;
+    if(filled_ < times_.size())
+    {
+        ++filled_;
+        return;
+    }
+    const auto mean = total_ / times_.size();
+    const auto budget = budget_ * (skipping_.load(std::memory_order_relaxed) ? 2.0 : 1.0);
+    if(mean > high_ * budget && level_ < levels_.size())
+    {
+        if(lifted_ && frames_at_level_ < 2 * times_.size())
+        {
+            recovery_ = std::min(recovery_ * 2, MAX_RECOVERY_WINDOWS * times_.size());
+        }
+        lifted_ = false;
+        change(level_ + 1, mean, budget, "over", high_);
+    }
+    else if(mean < low_ * budget && level_ > 0 && frames_at_level_ >= recovery_)
+    {
+        lifted_ = true;
+        change(level_ - 1, mean, budget, "under", low_);
+    }
+}
+
+const char* load_shedder::describe(degradation d, bool added) noexcept
+{
+    switch(d)
+    {
+    case degradation::optional_filters:
+        return added ? "optional filters off" : "optional filters back on";
+    case degradation::half_resolution:
+        return added ? "half resolution" : "full resolution";
+    case degradation::skip_frames:
+        return added ? "every other frame skipped" : "all frames processed";
+    }
+    return "";
+}
+
+void load_shedder::change(size_t level, double mean, double budget, const char* relation, double threshold)
+{
+    const bool up = level > level_;
+    const auto d = levels_[up ? level_ : level];
+    level_ = level;
+    max_level = std::max(max_level, level);
+    ++changes;
+    changed_ = true;
+    skipping_.store(active(degradation::skip_frames), std::memory_order_relaxed);
+    filled_ = 0;
+    total_ = 0.0;
+    std::fill(times_.begin(), times_.end(), 0.0);
+    frames_at_level_ = 0;
+    logger_.log(change_log_, iff::log_level::warning, "Stream `%s`: mean filter time %.1f ms %s %.0f%% of the %.1f ms budget, load shedding level %zu of %zu: %s",
+                stream_id_.c_str(), mean * 1e3, relation, threshold * 100.0, budget * 1e3, level, levels_.size(), describe(d, up));
+}
@@ -0,0 +1,113 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "async_logger.hpp"
+#include "stream_config.hpp"
+
+// Keeps the filter time of a stream within its frame budget by stepping
+// through the configured degradations. The mean filter time over the last
+// `window` frames is compared with the budget (doubled while every other
+// frame is skipped): above `high` of it the next degradation is added,
+// below `low` of it the last one is lifted again. Each decision needs a full
+// window measured at the current level, and lifting also waits for
+// `recovery` frames, which doubles whenever a lifted level had to be
+// restored within a window, so a load close to the budget does not flap.
+class load_shedder
+{
+public:
+    load_shedder(const load_shedding_config& config, std::vector<degradation> levels, const std::string& stream_id, async_logger& logger);
+
+    load_shedder(const load_shedder&) = delete;
+    load_shedder& operator=(const load_shedder&) = delete;
+
+    bool optional_filters_off() const noexcept
+    {
+        return active(degradation::optional_filters);
+    }
+
+    bool half_resolution() const noexcept
+    {
+        return active(degradation::half_resolution);
+    }
+
+    // called by the export callback; true for frames to drop unprocessed
+    bool skip_frame() noexcept;
+
+    // true once after each level change, when filters may have to reallocate for a new frame size
+    bool take_change() noexcept
+    {
+        return std::exchange(changed_, false);
+    }
+
+    // called by the processing thread after the filters of each frame
+    void record(std::chrono::steady_clock::duration filter_time);
+
+    // describes `d` being added to or lifted from the degradations in effect
+    static const char* describe(degradation d, bool added) noexcept;
+
+    // `skipped` is written by the export callback, the rest by the processing thread
+    uint64_t skipped = 0;
+    uint64_t changes = 0;
+    size_t max_level = 0;
+
+private:
+    static constexpr size_t MAX_RECOVERY_WINDOWS = 64;
+
+    bool active(degradation d) const noexcept
+    {
+        return std::find(levels_.begin(), levels_.begin() + level_, d) != levels_.begin() + level_;
+    }
+
+    void change(size_t level, double mean, double budget, const char* relation, double threshold);
+
+    const std::vector<degradation> levels_;
+    const double budget_; // seconds
+    const double high_;
+    const double low_;
+    std::vector<double> times_; // filter times of the last frames, seconds
+    size_t next_ = 0;
+    size_t filled_ = 0;
+    double total_ = 0.0;
+    size_t level_ = 0; // number of `levels_` in effect
+    size_t frames_at_level_ = 0;
+    size_t recovery_;
+    bool lifted_ = false;
+    bool changed_ = false;
+    std::atomic<bool> skipping_{false};
+    bool skip_next_ = false;
+    const std::string stream_id_;
+    async_logger& logger_;
+    async_logger::site change_log_;
+};
@@ -0,0 +1,431 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "lut3d_filter.hpp"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "simd.hpp"
+
+lut3d_filter::lut3d_filter(const nlohmann::json& config, const filter_context& context)
+{
+    if(context.channels < 3)
+    {
+        throw std::runtime_error("requires RGB or BGR frames");
+    }
+    bgr_ = context.format.rfind("BGR", 0) == 0;
+    load(config.at("file").get<std::string>());
+    // inputs outside of the domain take the value of its nearest edge
+    for(uint32_t c = 0; c < 3; ++c)
+    {
+        for(uint32_t value = 0; value < 256; ++value)
+        {
+            const auto normalized = std::clamp((value / 255.0f - domain_min_[c]) / (domain_max_[c] - domain_min_[c]), 0.0f, 1.0f);
+            const auto position = static_cast<uint32_t>(normalized * float(size_ - 1) * 256.0f + 0.5f);
+            const auto index = std::min(position >> 8, size_ - 2);
+            axis_[c][value] = {index, position - index * 256};
+        }
+    }
+    if(config.value("baked", false))
+    {
+        bake();
+    }
+}
+
+void lut3d_filter::apply(const frame_view& frame, stripe_pool& pool)
+{
+    const auto channels = frame.channels;
+    const auto red = bgr_ ? 2 : 0;
+    const auto blue = bgr_ ? 0 : 2;
+    pool.run(frame.height, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = begin; y < end; ++y)
+        {
+            uint8_t* pixel = frame.row(y);
+            uint32_t x = 0;
+            if(baked_.empty())
+            {
+                for(; x + BATCH <= frame.width; x += BATCH, pixel += BATCH * channels)
+                {
+                    uint8_t in[3][BATCH];
+                    uint8_t out[3][BATCH];
+                    for(uint32_t i = 0; i < BATCH; ++i)
+                    {
+                        in[0][i] = pixel[i * channels + red];
+                        in[1][i] = pixel[i * channels + 1];
+                        in[2][i] = pixel[i * channels + blue];
+                    }
+                    interpolate_batch(in, out);
+                    for(uint32_t i = 0; i < BATCH; ++i)
+                    {
+                        pixel[i * channels + red] = out[0][i];
+                        pixel[i * channels + 1] = out[1][i];
+                        pixel[i * channels + blue] = out[2][i];
+                    }
+                }
+            }
+            for(; x < frame.width; ++x, pixel += channels)
+            {
+                uint8_t rgb[3];
+                if(!baked_.empty())
+                {
+                    std::memcpy(rgb, &baked_[3 * ((size_t(pixel[red]) << 16) | (size_t(pixel[1]) << 8) | pixel[blue])], 3);
+                }
+                else
+                {
+                    interpolate(pixel[red], pixel[1], pixel[blue], rgb);
+                }
+                pixel[red] = rgb[0];
+                pixel[1] = rgb[1];
+                pixel[blue] = rgb[2];
+            }
+        }
+    });
+}
+
+void lut3d_filter::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if(!file)
+    {
+        throw std::runtime_error("cannot open `" + path + "`");
+    }
+    std::vector<float> values;
+    std::string line;
+    size_t line_number = 0;
+    while(std::getline(file, line))
+    {
+        ++line_number;
+        std::istringstream tokens(line);
+        std::string keyword;
+        if(!(tokens >> keyword) || keyword[0] == '#')
+        {
+            continue;
+        }
+        if(keyword == "LUT_3D_SIZE")
+        {
+            tokens >> size_;
+        }
+        else if(keyword == "DOMAIN_MIN")
+        {
+            tokens >> domain_min_[0] >> domain_min_[1] >> domain_min_[2];
+        }
+        else if(keyword == "DOMAIN_MAX")
+        {
+            tokens >> domain_max_[0] >> domain_max_[1] >> domain_max_[2];
+        }
+        else if(keyword == "TITLE" || keyword == "LUT_1D_SIZE" || keyword == "LUT_1D_INPUT_RANGE" || keyword == "LUT_3D_INPUT_RANGE")
+        {
+            if(keyword == "LUT_1D_SIZE")
+            {
+                throw std::runtime_error("`" + path + "` contains a 1D LUT");
+            }
+            continue;
+        }
+        else
+        {
+            float rgb[3];
+            std::istringstream numbers(line);
+            if(!(numbers >> rgb[0] >> rgb[1] >> rgb[2]))
+            {
+                throw std::runtime_error("`" + path + "` line " + std::to_string(line_number) + ": unexpected `" + keyword + "`");
+            }
+            values.insert(values.end(), rgb, rgb + 3);
+        }
+        if(!tokens)
+        {
+            throw std::runtime_error("`" + path + "` line " + std::to_string(line_number) + ": invalid `" + keyword + "`");
+        }
+    }
+    if(size_ < 2 || size_ > 65)
+    {
+        throw std::runtime_error("`" + path + "`: `LUT_3D_SIZE` must be in [2, 65]");
+    }
+    for(size_t c = 0; c < 3; ++c)
+    {
+        if(!(domain_max_[c] > domain_min_[c]))
+        {
+            throw std::runtime_error("`" + path + "`: `DOMAIN_MAX` must be greater than `DOMAIN_MIN`");
+        }
+    }
+    if(values.size() != size_t(size_) * size_ * size_ * 3)
+    {
+        throw std::runtime_error("`" + path + "`: expected " + std::to_string(size_t(size_) * size_ * size_) + " entries");
+    }
+    lattice_.resize(size_t(size_) * size_ * size_);
+    for(size_t i = 0; i < lattice_.size(); ++i)
+    {
+        // output values are in [0, 1] whatever the input domain
+        for(size_t c = 0; c < 3; ++c)
+        {
+            lattice_[i].channel[c] = static_cast<uint16_t>(std::clamp(values[i * 3 + c], 0.0f, 1.0f) * 255.0f * 256.0f + 0.5f);
+        }
+        lattice_[i].channel[3] = 0;
+    }
+}
+
+void lut3d_filter::interpolate(uint8_t r, uint8_t g, uint8_t b, uint8_t* rgb) const noexcept
+{
+    const auto [ri, fr] = axis_[0][r];
+    const auto [gi, fg] = axis_[1][g];
+    const auto [bi, fb] = axis_[2][b];
+    const size_t step_g = size_;
+    const size_t step_b = size_t(size_) * size_;
+    const auto base = lattice_.data() + bi * step_b + gi * step_g + ri;
+    const auto& c000 = base[0];
+    const auto& c111 = base[step_b + step_g + 1];
+    // the other two corners of the tetrahedron containing the point, and weights summing to 256
+    const entry* c1;
+    const entry* c2;
+    uint32_t w0, w1, w2, w3;
+    if(fr > fg)
+    {
+        if(fg > fb)
+        {
+            c1 = base + 1;
+            c2 = base + step_g + 1;
+            w0 = 256 - fr; w1 = fr - fg; w2 = fg - fb; w3 = fb;
+        }
+        else if(fr > fb)
+        {
+            c1 = base + 1;
+            c2 = base + step_b + 1;
+            w0 = 256 - fr; w1 = fr - fb; w2 = fb - fg; w3 = fg;
+        }
+        else
+        {
+            c1 = base + step_b;
+            c2 = base + step_b + 1;
+            w0 = 256 - fb; w1 = fb - fr; w2 = fr - fg; w3 = fg;
+        }
+    }
+    else
+    {
+        if(fb > fg)
+        {
+            c1 = base + step_b;
+            c2 = base + step_b + step_g;
+            w0 = 256 - fb; w1 = fb - fg; w2 = fg - fr; w3 = fr;
+        }
+        else if(fb > fr)
+        {
+            c1 = base + step_g;
+            c2 = base + step_b + step_g;
+            w0 = 256 - fg; w1 = fg - fb; w2 = fb - fr; w3 = fr;
+        }
+        else
+        {
+            c1 = base + step_g;
+            c2 = base + step_g + 1;
+            w0 = 256 - fg; w1 = fg - fr; w2 = fr - fb; w3 = fb;
+        }
+    }
+    for(size_t c = 0; c < 3; ++c)
+    {
+        const auto value = w0 * c000.channel[c] + w1 * c1->channel[c] + w2 * c2->channel[c] + w3 * c111.channel[c];
+        rgb[c] = static_cast<uint8_t>((value + 32768) >> 16);
+    }
+}
+
+void lut3d_filter::interpolate_batch(const uint8_t (&in)[3][BATCH], uint8_t (&out)[3][BATCH]) const noexcept
+{
+    const uint32_t step_g = size_;
+    const uint32_t step_b = size_ * size_;
+    uint32_t base[BATCH];
+    alignas(16) uint16_t fraction[3][BATCH];
+    for(uint32_t i = 0; i < BATCH; ++i)
+    {
+        const auto r = axis_[0][in[0][i]];
+        const auto g = axis_[1][in[1][i]];
+        const auto b = axis_[2][in[2][i]];
+        base[i] = b.index * step_b + g.index * step_g + r.index;
+        fraction[0][i] = static_cast<uint16_t>(r.fraction);
+        fraction[1][i] = static_cast<uint16_t>(g.fraction);
+        fraction[2][i] = static_cast<uint16_t>(b.fraction);
+    }
+
+    // offsets stay below 65 * 65 + 65 + 1, weights at most 256, so 16-bit lanes suffice
+    alignas(16) uint16_t weight[4][BATCH];
+    alignas(16) uint16_t offset1[BATCH];
+    alignas(16) uint16_t offset2[BATCH];
+#if defined(IFF_SSE2)
+    const auto fr = _mm_load_si128(reinterpret_cast<const __m128i*>(fraction[0]));
+    const auto fg = _mm_load_si128(reinterpret_cast<const __m128i*>(fraction[1]));
+    const auto fb = _mm_load_si128(reinterpret_cast<const __m128i*>(fraction[2]));
+    const auto ones = _mm_set1_epi16(-1);
+    const auto g_over_r = _mm_cmpgt_epi16(fg, fr);
+    const auto b_over_r = _mm_cmpgt_epi16(fb, fr);
+    const auto b_over_g = _mm_cmpgt_epi16(fb, fg);
+    const auto r_max = _mm_andnot_si128(_mm_or_si128(g_over_r, b_over_r), ones);
+    const auto g_max = _mm_andnot_si128(b_over_g, g_over_r);
+    const auto b_max = _mm_and_si128(b_over_r, b_over_g);
+    const auto r_min = _mm_and_si128(g_over_r, b_over_r);
+    const auto g_min = _mm_andnot_si128(g_over_r, b_over_g);
+    const auto b_min = _mm_andnot_si128(_mm_or_si128(b_over_r, b_over_g), ones);
+    const auto step = [&](__m128i r, __m128i g, __m128i b)
+    {
+        return _mm_or_si128(_mm_or_si128(_mm_and_si128(r, _mm_set1_epi16(1)), _mm_and_si128(g, _mm_set1_epi16(static_cast<int16_t>(step_g)))),
+                            _mm_and_si128(b, _mm_set1_epi16(static_cast<int16_t>(step_b))));
+    };
+    const auto c1 = step(r_max, g_max, b_max);
+    const auto c2 = _mm_add_epi16(c1, step(_mm_andnot_si128(_mm_or_si128(r_max, r_min), ones), _mm_andnot_si128(_mm_or_si128(g_max, g_min), ones),
+                                           _mm_andnot_si128(_mm_or_si128(b_max, b_min), ones)));
+    const auto high = _mm_max_epi16(_mm_max_epi16(fr, fg), fb);
+    const auto low = _mm_min_epi16(_mm_min_epi16(fr, fg), fb);
+    const auto middle = _mm_sub_epi16(_mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(fr, fg), fb), high), low);
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset1), c1);
+    _mm_store_si128(reinterpret_cast<__m128i*>(offset2), c2);
+    _mm_store_si128(reinterpret_cast<__m128i*>(weight[0]), _mm_sub_epi16(_mm_set1_epi16(256), high));
+    _mm_store_si128(reinterpret_cast<__m128i*>(weight[1]), _mm_sub_epi16(high, middle));
+    _mm_store_si128(reinterpret_cast<__m128i*>(weight[2]), _mm_sub_epi16(middle, low));
+    _mm_store_si128(reinterpret_cast<__m128i*>(weight[3]), low);
+#elif defined(IFF_NEON)
+    const auto fr = vld1q_u16(fraction[0]);
+    const auto fg = vld1q_u16(fraction[1]);
+    const auto fb = vld1q_u16(fraction[2]);
+    const auto g_over_r = vcgtq_u16(fg, fr);
+    const auto b_over_r = vcgtq_u16(fb, fr);
+    const auto b_over_g = vcgtq_u16(fb, fg);
+    const auto r_max = vmvnq_u16(vorrq_u16(g_over_r, b_over_r));
+    const auto g_max = vbicq_u16(g_over_r, b_over_g);
+    const auto b_max = vandq_u16(b_over_r, b_over_g);
+    const auto r_min = vandq_u16(g_over_r, b_over_r);
+    const auto g_min = vbicq_u16(b_over_g, g_over_r);
+    const auto b_min = vmvnq_u16(vorrq_u16(b_over_r, b_over_g));
+    const auto step = [&](uint16x8_t r, uint16x8_t g, uint16x8_t b)
+    {
+        return vorrq_u16(vorrq_u16(vandq_u16(r, vdupq_n_u16(1)), vandq_u16(g, vdupq_n_u16(static_cast<uint16_t>(step_g)))),
+                         vandq_u16(b, vdupq_n_u16(static_cast<uint16_t>(step_b))));
+    };
+    const auto c1 = step(r_max, g_max, b_max);
+    const auto c2 = vaddq_u16(c1, step(vmvnq_u16(vorrq_u16(r_max, r_min)), vmvnq_u16(vorrq_u16(g_max, g_min)), vmvnq_u16(vorrq_u16(b_max, b_min))));
+    const auto high = vmaxq_u16(vmaxq_u16(fr, fg), fb);
+    const auto low = vminq_u16(vminq_u16(fr, fg), fb);
+    const auto middle = vsubq_u16(vsubq_u16(vaddq_u16(vaddq_u16(fr, fg), fb), high), low);
+    vst1q_u16(offset1, c1);
+    vst1q_u16(offset2, c2);
+    vst1q_u16(weight[0], vsubq_u16(vdupq_n_u16(256), high));
+    vst1q_u16(weight[1], vsubq_u16(high, middle));
+    vst1q_u16(weight[2], vsubq_u16(middle, low));
+    vst1q_u16(weight[3], low);
+#else
+    for(uint32_t i = 0; i < BATCH; ++i)
+    {
+        const uint32_t fr = fraction[0][i], fg = fraction[1][i], fb = fraction[2][i];
+        const bool g_over_r = fg > fr, b_over_r = fb > fr, b_over_g = fb > fg;
+        const bool r_max = !g_over_r && !b_over_r, g_max = g_over_r && !b_over_g, b_max = b_over_r && b_over_g;
+        const bool r_min = g_over_r && b_over_r, g_min = !g_over_r && b_over_g, b_min = !b_over_r && !b_over_g;
+        const auto high = std::max({fr, fg, fb});
+        const auto low = std::min({fr, fg, fb});
+        const auto middle = fr + fg + fb - high - low;
+        offset1[i] = static_cast<uint16_t>(r_max * 1 + g_max * step_g + b_max * step_b);
+        offset2[i] = static_cast<uint16_t>(offset1[i] + !(r_max || r_min) * 1 + !(g_max || g_min) * step_g + !(b_max || b_min) * step_b);
+        weight[0][i] = static_cast<uint16_t>(256 - high);
+        weight[1][i] = static_cast<uint16_t>(high - middle);
+        weight[2][i] = static_cast<uint16_t>(middle - low);
+        weight[3][i] = static_cast<uint16_t>(low);
+    }
+#endif
+
+    // gather the four corners of every pixel, channel-planar for the blend
+    alignas(16) uint16_t corner[3][4][BATCH];
+    const uint32_t far = step_b + step_g + 1;
+    for(uint32_t i = 0; i < BATCH; ++i)
+    {
+        const auto c000 = lattice_.data() + base[i];
+        const entry* const corners[4] = {c000, c000 + offset1[i], c000 + offset2[i], c000 + far};
+        for(uint32_t k = 0; k < 4; ++k)
+        {
+            for(uint32_t c = 0; c < 3; ++c)
+            {
+                corner[c][k][i] = corners[k]->channel[c];
+            }
+        }
+    }
+
+    // weights sum to 256 and corners are at most 255 * 256, so sums fit 32 bits
+    for(uint32_t c = 0; c < 3; ++c)
+    {
+#if defined(IFF_SSE2)
+        auto sum_low = _mm_setzero_si128();
+        auto sum_high = _mm_setzero_si128();
+        for(uint32_t k = 0; k < 4; ++k)
+        {
+            const auto w = _mm_load_si128(reinterpret_cast<const __m128i*>(weight[k]));
+            const auto v = _mm_load_si128(reinterpret_cast<const __m128i*>(corner[c][k]));
+            const auto product_low = _mm_mullo_epi16(w, v);
+            const auto product_high = _mm_mulhi_epu16(w, v);
+            sum_low = _mm_add_epi32(sum_low, _mm_unpacklo_epi16(product_low, product_high));
+            sum_high = _mm_add_epi32(sum_high, _mm_unpackhi_epi16(product_low, product_high));
+        }
+        const auto round = _mm_set1_epi32(32768);
+        sum_low = _mm_srli_epi32(_mm_add_epi32(sum_low, round), 16);
+        sum_high = _mm_srli_epi32(_mm_add_epi32(sum_high, round), 16);
+        const auto bytes = _mm_packus_epi16(_mm_packs_epi32(sum_low, sum_high), _mm_setzero_si128());
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out[c]), bytes);
+#elif defined(IFF_NEON)
+        uint32x4_t sum_low = vdupq_n_u32(0);
+        uint32x4_t sum_high = vdupq_n_u32(0);
+        for(uint32_t k = 0; k < 4; ++k)
+        {
+            const auto w = vld1q_u16(weight[k]);
+            const auto v = vld1q_u16(corner[c][k]);
+            sum_low = vmlal_u16(sum_low, vget_low_u16(w), vget_low_u16(v));
+            sum_high = vmlal_u16(sum_high, vget_high_u16(w), vget_high_u16(v));
+        }
+        vst1_u8(out[c], vmovn_u16(vcombine_u16(vrshrn_n_u32(sum_low, 16), vrshrn_n_u32(sum_high, 16))));
+#else
+        for(uint32_t i = 0; i < BATCH; ++i)
+        {
+            uint32_t value = 0;
+            for(uint32_t k = 0; k < 4; ++k)
+            {
+                value += uint32_t(weight[k][i]) * corner[c][k][i];
+            }
+            out[c][i] = static_cast<uint8_t>((value + 32768) >> 16);
+        }
+#endif
+    }
+}
+
+void lut3d_filter::bake()
+{
+    baked_.resize(size_t(3) << 24);
+    for(uint32_t r = 0; r < 256; ++r)
+    {
+        for(uint32_t g = 0; g < 256; ++g)
+        {
+            uint8_t* const out = &baked_[3 * ((size_t(r) << 16) | (size_t(g) << 8))];
+            for(uint32_t b = 0; b < 256; ++b)
+            {
+                interpolate(static_cast<uint8_t>(r), static_cast<uint8_t>(g), static_cast<uint8_t>(b), out + 3 * b);
+            }
+        }
+    }
+}
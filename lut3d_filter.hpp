@@ -0,0 +1,95 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// 3D LUT colour grading from a .cube file (`LUT_3D_SIZE` 2-65, input range set
+// per channel by `DOMAIN_MIN` and `DOMAIN_MAX`, default 0-1). The lattice is
+// stored as 16-bit RGB padded to four lanes, blue-major like the file, so each
+// corner is a single 8-byte load and neighbouring red entries share cache lines.
+// Pixels are interpolated tetrahedrally in fixed point, eight at a time: the
+// tetrahedron of each pixel is chosen with compare masks instead of branches
+// and the corners are blended in SIMD lanes (SSE2 or NEON), so the cost is the
+// eight-corner gather rather than mispredicted branches. With `baked` (off by
+// default) every possible RGB8 input is evaluated once at startup into a
+// 16M-entry table (48 MiB) and filtering becomes a single lookup per pixel,
+// trading memory and cache footprint for arithmetic.
+class lut3d_filter final : public filter
+{
+public:
+    lut3d_filter(const nlohmann::json& config, const filter_context& context);
+
+    bool scale_invariant() const noexcept override
+    {
+        return true;
+    }
+
+    void apply(const frame_view& frame, stripe_pool& pool) override;
+
+private:
+    static constexpr uint32_t BATCH = 8;
+
+    struct entry
+    {
+        uint16_t channel[4]; // RGB scaled to 255 * 256, fourth lane unused
+    };
+
+    struct axis_position
+    {
+        uint32_t index;
+        uint32_t fraction; // 0-256
+    };
+
+    void load(const std::string& path);
+
+    void interpolate(uint8_t r, uint8_t g, uint8_t b, uint8_t* rgb) const noexcept;
+
+    // Same result as `interpolate()` for BATCH pixels (`in` and `out` are RGB planes).
+    // Fractions are ranked with ties going to red, then green, so every pixel gets
+    // three distinct axes; corner c1 steps along the largest fraction, c2 also along
+    // the middle one, with weights 256 - max, max - mid, mid - min and min.
+    void interpolate_batch(const uint8_t (&in)[3][BATCH], uint8_t (&out)[3][BATCH]) const noexcept;
+
+    void bake();
+
+    bool bgr_ = false;
+    uint32_t size_ = 0;
+    float domain_min_[3] = {0.0f, 0.0f, 0.0f};
+    float domain_max_[3] = {1.0f, 1.0f, 1.0f};
+    std::vector<entry> lattice_; // blue-major, red fastest
+    axis_position axis_[3][256]; // lattice position of each 8-bit input value, per channel
+    std::vector<uint8_t> baked_;
+};
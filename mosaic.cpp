@@ -0,0 +1,149 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "mosaic.hpp"
+
+// std
+#include <sstream>
+#include <utility>
+
+#include "tracer.hpp"
+
+mosaic::mosaic(mosaic_config&& config, const std::map<std::string, std::shared_ptr<iff::chain>>& chains, async_logger& logger)
+    : id(config.id)
+    , tile_streams(std::move(config.tiles))
+    , importer_{chains.at(config.importer.chain), config.importer.element}
+    , channels_(config.channels)
+    , width_(config.width)
+    , height_(config.height)
+    , period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / config.fps)))
+    , method_(config.method)
+    , canvas_(size_t(config.width) * config.height * config.channels, 0)
+    , logger_(logger)
+    , drop_log_(logger, "Mosaic `" + config.id + "` frame dropped")
+{
+    for(uint32_t row = 0; row < config.rows; ++row)
+    {
+        for(uint32_t column = 0; column < config.columns; ++column)
+        {
+            // cells partition the canvas, so copying every tile copies all of it
+            const auto x0 = static_cast<uint32_t>(uint64_t(width_) * column / config.columns);
+            const auto x1 = static_cast<uint32_t>(uint64_t(width_) * (column + 1) / config.columns);
+            const auto y0 = static_cast<uint32_t>(uint64_t(height_) * row / config.rows);
+            const auto y1 = static_cast<uint32_t>(uint64_t(height_) * (row + 1) / config.rows);
+            tiles_.push_back(std::make_unique<tile>(*this, x0, y0, x1 - x0, y1 - y0));
+        }
+    }
+}
+
+void mosaic::start()
+{
+    thread_ = std::thread([this]()
+    {
+        tracer::name_thread("mosaic " + id);
+        const tracer::context_scope trace(id.c_str(), 0);
+        run();
+    });
+}
+
+void mosaic::stop()
+{
+    if(thread_.joinable())
+    {
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+}
+
+void mosaic::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true)
+    {
+        next += period_;
+        if(cv_.wait_until(lock, next, [this](){ return stop_; }))
+        {
+            return;
+        }
+        lock.unlock();
+        compose(next);
+        lock.lock();
+        // after a stall the cadence restarts instead of catching up with a burst of frames
+        const auto now = std::chrono::steady_clock::now();
+        if(now >= next + period_)
+        {
+            missed_ticks += static_cast<uint64_t>((now - next) / period_);
+            next = now;
+        }
+    }
+}
+
+void mosaic::compose(std::chrono::steady_clock::time_point tick)
+{
+    auto buffer = import_buffer::acquire(importer_);
+    if(!buffer)
+    {
+        ++drops;
+        logger_.log(drop_log_, iff::log_level::warning, "Mosaic `%s`: no free import buffer, skipping frame", id.c_str());
+        return;
+    }
+    if(buffer.size() < canvas_.size())
+    {
+        ++drops;
+        logger_.log(drop_log_, iff::log_level::error, "Mosaic `%s`: import buffer is too small (%zu < %zu)", id.c_str(), buffer.size(), canvas_.size());
+        return;
+    }
+    const auto stride = size_t(width_) * channels_;
+    for(const auto& t : tiles_)
+    {
+        std::scoped_lock<std::mutex> lock(t->mutex_);
+        const auto offset = size_t(t->x_) * channels_;
+        const auto length = size_t(t->width_) * channels_;
+        for(uint32_t y = t->y_; y < t->y_ + t->height_; ++y)
+        {
+            std::memcpy(buffer.data() + y * stride + offset, canvas_.data() + y * stride + offset, length);
+        }
+    }
+    iff::image_metadata metadata{};
+    metadata.width = width_;
+    metadata.height = height_;
+    metadata.padding = 0;
+    metadata.timestamp = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(tick.time_since_epoch()).count());
+    metadata.frame_number = frames;
+    buffer.set_metadata(metadata);
+    buffer.push();
+    ++frames;
+}
+
+void mosaic::log_statistics() const
+{
+    std::ostringstream message;
+    message << "Mosaic `" << id << "`: " << frames << " frames, " << drops << " dropped, " << missed_ticks << " ticks missed";
+    iff::log(iff::log_level::info, "imagefiltercpp", message.str());
+}
@@ -0,0 +1,169 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "async_logger.hpp"
+#include "frame_scaler.hpp"
+#include "frame_view.hpp"
+#include "import_buffer.hpp"
+#include "stream_config.hpp"
+#include "stripe_pool.hpp"
+
+// Grid of the latest filtered frames of several streams, pushed to its own
+// importer at a fixed rate by a dedicated thread. Processing threads scale
+// their frames straight into their tile of a persistent canvas (keeping the
+// aspect ratio); each tick copies the canvas into an import buffer, so tiles
+// of cameras that stopped delivering keep their last picture and the output
+// never stalls. Every tile has its own lock, so a stream only ever waits for
+// the copy of its own tile.
+class mosaic
+{
+public:
+    class tile
+    {
+    public:
+        tile(mosaic& owner, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+            : owner_(owner)
+            , x_(x)
+            , y_(y)
+            , width_(width)
+            , height_(height)
+            , scaler_(owner.method_)
+        {
+        }
+
+        // called by the processing thread of the stream shown in this tile
+        void update(const frame_view& frame, stripe_pool& pool)
+        {
+            std::scoped_lock<std::mutex> lock(mutex_);
+            if(frame.width != frame_width_ || frame.height != frame_height_)
+            {
+                fit(frame.width, frame.height);
+            }
+            const auto channels = owner_.channels_;
+            const auto stride = size_t(owner_.width_) * channels;
+            uint8_t* const picture = owner_.canvas_.data() + size_t(y_ + fit_y_) * stride + size_t(x_ + fit_x_) * channels;
+            scaler_.scale(frame, frame_view{picture, fit_width_, fit_height_, stride, channels}, pool);
+        }
+
+    private:
+        friend class mosaic;
+
+        // letterboxes frames of the new size into the cell and clears the cell
+        void fit(uint32_t frame_width, uint32_t frame_height)
+        {
+            frame_width_ = frame_width;
+            frame_height_ = frame_height;
+            const double scale = std::min(double(width_) / frame_width, double(height_) / frame_height);
+            fit_width_ = std::clamp(static_cast<uint32_t>(frame_width * scale + 0.5), 1u, width_);
+            fit_height_ = std::clamp(static_cast<uint32_t>(frame_height * scale + 0.5), 1u, height_);
+            fit_x_ = (width_ - fit_width_) / 2;
+            fit_y_ = (height_ - fit_height_) / 2;
+            const auto stride = size_t(owner_.width_) * owner_.channels_;
+            for(uint32_t y = y_; y < y_ + height_; ++y)
+            {
+                std::memset(owner_.canvas_.data() + y * stride + size_t(x_) * owner_.channels_, 0, size_t(width_) * owner_.channels_);
+            }
+        }
+
+        mosaic& owner_;
+        const uint32_t x_, y_, width_, height_; // cell in the canvas
+        std::mutex mutex_;
+        frame_scaler scaler_;
+        uint32_t frame_width_ = 0;
+        uint32_t frame_height_ = 0;
+        uint32_t fit_x_ = 0, fit_y_ = 0, fit_width_ = 0, fit_height_ = 0; // picture within the cell
+    };
+
+    mosaic(mosaic_config&& config, const std::map<std::string, std::shared_ptr<iff::chain>>& chains, async_logger& logger);
+
+    ~mosaic()
+    {
+        stop();
+    }
+
+    mosaic(const mosaic&) = delete;
+    mosaic& operator=(const mosaic&) = delete;
+
+    // cell `index` in row-major order, showing `tile_streams[index]`
+    tile& at(size_t index) noexcept
+    {
+        return *tiles_[index];
+    }
+
+    void start();
+
+    void stop();
+
+    // statistics, logged once stopped
+    void log_statistics() const;
+
+    const std::string id;
+    const std::vector<std::string> tile_streams;
+
+    // written by the mosaic thread, read after `stop()`
+    uint64_t frames = 0;
+    uint64_t drops = 0;         // no free import buffer or buffer too small
+    uint64_t missed_ticks = 0;  // ticks skipped after the thread fell behind
+
+private:
+    void run();
+
+    // `tick` becomes the timestamp, in microseconds, so the composed stream has an even cadence
+    void compose(std::chrono::steady_clock::time_point tick);
+
+    const import_target importer_;
+    const uint32_t channels_;
+    const uint32_t width_;
+    const uint32_t height_;
+    const std::chrono::steady_clock::duration period_;
+    const frame_scaler::method method_;
+    std::vector<uint8_t> canvas_;
+    std::vector<std::unique_ptr<tile>> tiles_;
+    async_logger& logger_;
+    async_logger::site drop_log_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
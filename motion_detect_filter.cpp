@@ -0,0 +1,301 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "motion_detect_filter.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+motion_detect_filter::motion_detect_filter(const nlohmann::json& config, const filter_context& context)
+    : stream_id_(context.stream_id)
+    , logger_(context.logger)
+    , start_log_(context.logger, "Stream `" + context.stream_id + "` motion start", std::chrono::nanoseconds(0))
+    , update_log_(context.logger, "Stream `" + context.stream_id + "` motion update")
+    , end_log_(context.logger, "Stream `" + context.stream_id + "` motion end", std::chrono::nanoseconds(0))
+{
+    block_size_ = config.value("block_size", 16u);
+    if(block_size_ != 8 && block_size_ != 16)
+    {
+        throw std::runtime_error("`block_size` must be 8 or 16");
+    }
+    const auto learning_rate = config.value("learning_rate", 0.05);
+    if(!(learning_rate > 0.0 && learning_rate <= 1.0))
+    {
+        throw std::runtime_error("`learning_rate` must be in (0, 1]");
+    }
+    learning_rate_ = std::max(1, static_cast<int32_t>(learning_rate * 256.0 + 0.5));
+    threshold_ = config.value("threshold", 12);
+    if(threshold_ <= 0 || threshold_ > 255)
+    {
+        throw std::runtime_error("`threshold` must be in [1, 255]");
+    }
+    min_blocks_ = config.value("min_blocks", 4u);
+    hold_frames_ = config.value("hold_frames", 15u);
+    if(hold_frames_ == 0)
+    {
+        throw std::runtime_error("`hold_frames` must be positive");
+    }
+    absorb_frames_ = config.value("absorb_frames", 300u);
+    if(absorb_frames_ <= hold_frames_)
+    {
+        throw std::runtime_error("`absorb_frames` must be greater than `hold_frames`");
+    }
+    draw_ = config.value("draw", false);
+}
+
+void motion_detect_filter::apply(const frame_view& frame, stripe_pool& pool)
+{
+    const bool primed = prepare(frame);
+    pool.run(rows_, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t by = begin; by < end; ++by)
+        {
+            update_row(frame, by, primed);
+        }
+    });
+    if(!primed)
+    {
+        return;
+    }
+
+    find_regions();
+    if(region_count_ != 0)
+    {
+        if(idle_frames_ >= hold_frames_)
+        {
+            motion_frames_ = 0;
+            report(start_log_, "motion started");
+        }
+        else
+        {
+            report(update_log_, "motion");
+        }
+        idle_frames_ = 0;
+        ++motion_frames_;
+        if(draw_)
+        {
+            draw_regions(frame);
+        }
+    }
+    else if(idle_frames_ < hold_frames_ && ++idle_frames_ == hold_frames_)
+    {
+        logger_.log(end_log_, iff::log_level::info, "Stream `%s`: motion ended after %u frame(s)", stream_id_.c_str(), motion_frames_);
+    }
+}
+
+bool motion_detect_filter::prepare(const frame_view& frame)
+{
+    const auto columns = frame.width / block_size_;
+    const auto rows = frame.height / block_size_;
+    if(columns == columns_ && rows == rows_ && frame.channels == channels_)
+    {
+        return true;
+    }
+    columns_ = columns;
+    rows_ = rows;
+    channels_ = frame.channels;
+    sums_.assign(size_t(columns) * rows, 0);
+    background_.assign(size_t(columns) * rows, 0);
+    mask_.assign(size_t(columns) * rows, 0);
+    motion_age_.assign(size_t(columns) * rows, 0);
+    labels_.assign(size_t(columns) * rows, 0);
+    stack_.resize(size_t(columns) * rows);
+    idle_frames_ = hold_frames_;
+    return false;
+}
+
+void motion_detect_filter::update_row(const frame_view& frame, uint32_t by, bool primed) noexcept
+{
+    const auto channels = channels_;
+    const auto block = block_size_;
+    const auto columns = columns_;
+    const auto sums = sums_.data() + size_t(by) * columns;
+    std::fill(sums, sums + columns, 0);
+    for(uint32_t y = by * block; y < (by + 1) * block; y += 2)
+    {
+        const auto row = frame.row(y);
+        for(uint32_t bx = 0; bx < columns; ++bx)
+        {
+            const auto pixels = row + size_t(bx) * block * channels;
+            uint32_t sum = 0;
+            if(channels == 1)
+            {
+                for(uint32_t x = 0; x < block; ++x)
+                {
+                    sum += pixels[x];
+                }
+            }
+            else
+            {
+                for(uint32_t x = 0; x < block; ++x)
+                {
+                    const auto pixel = pixels + x * channels;
+                    sum += (pixel[0] + 2 * pixel[1] + pixel[2]) >> 2;
+                }
+            }
+            sums[bx] += sum;
+        }
+    }
+    const auto shift = block == 16 ? 7 : 5; // samples per block: block * block / 2
+    for(uint32_t bx = 0; bx < columns; ++bx)
+    {
+        const auto index = size_t(by) * columns_ + bx;
+        const int32_t mean = static_cast<int32_t>(sums[bx] >> shift) << 8;
+        const int32_t background = primed ? background_[index] : mean;
+        const int32_t difference = mean - background;
+        const bool moving = std::abs(difference) > (threshold_ << 8);
+        // moving blocks keep their background, unless they stay moving long enough to be taken as a new static scene
+        if(!moving)
+        {
+            background_[index] = static_cast<uint16_t>(background + ((difference * learning_rate_) >> 8));
+            motion_age_[index] = 0;
+        }
+        else if(++motion_age_[index] >= absorb_frames_)
+        {
+            background_[index] = static_cast<uint16_t>(mean);
+            motion_age_[index] = 0;
+        }
+        mask_[index] = moving ? 1 : 0;
+    }
+}
+
+void motion_detect_filter::find_regions() noexcept
+{
+    region_count_ = 0;
+    std::fill(labels_.begin(), labels_.end(), 0);
+    for(size_t start = 0; start < mask_.size(); ++start)
+    {
+        if(mask_[start] == 0 || labels_[start] != 0)
+        {
+            continue;
+        }
+        region current{columns_, rows_, 0, 0, 0};
+        size_t top = 0;
+        stack_[top++] = static_cast<uint32_t>(start);
+        labels_[start] = 1;
+        while(top != 0)
+        {
+            const auto index = stack_[--top];
+            const auto x = index % columns_;
+            const auto y = index / columns_;
+            current.x0 = std::min(current.x0, x);
+            current.y0 = std::min(current.y0, y);
+            current.x1 = std::max(current.x1, x);
+            current.y1 = std::max(current.y1, y);
+            ++current.blocks;
+            const auto visit = [&](uint32_t neighbour)
+            {
+                if(mask_[neighbour] != 0 && labels_[neighbour] == 0)
+                {
+                    labels_[neighbour] = 1;
+                    stack_[top++] = neighbour;
+                }
+            };
+            if(x > 0)
+            {
+                visit(index - 1);
+            }
+            if(x + 1 < columns_)
+            {
+                visit(index + 1);
+            }
+            if(y > 0)
+            {
+                visit(index - columns_);
+            }
+            if(y + 1 < rows_)
+            {
+                visit(index + columns_);
+            }
+        }
+        if(current.blocks < min_blocks_)
+        {
+            continue;
+        }
+        if(region_count_ < MAX_REGIONS)
+        {
+            regions_[region_count_++] = current;
+        }
+        else
+        {
+            const auto smallest = std::min_element(regions_, regions_ + MAX_REGIONS,
+                                                   [](const region& a, const region& b){ return a.blocks < b.blocks; });
+            if(smallest->blocks < current.blocks)
+            {
+                *smallest = current;
+            }
+        }
+    }
+}
+
+void motion_detect_filter::report(async_logger::site& site, const char* event)
+{
+    char boxes[LOG_MESSAGE_SIZE / 2];
+    size_t length = 0;
+    for(size_t i = 0; i < region_count_ && length < sizeof(boxes); ++i)
+    {
+        const auto& r = regions_[i];
+        const auto written = std::snprintf(boxes + length, sizeof(boxes) - length, " [%u,%u %ux%u]",
+                                           r.x0 * block_size_, r.y0 * block_size_,
+                                           (r.x1 - r.x0 + 1) * block_size_, (r.y1 - r.y0 + 1) * block_size_);
+        if(written < 0)
+        {
+            break;
+        }
+        length += static_cast<size_t>(written);
+    }
+    boxes[std::min(length, sizeof(boxes) - 1)] = '\0';
+    logger_.log(site, iff::log_level::info, "Stream `%s`: %s in %zu region(s):%s", stream_id_.c_str(), event, region_count_, boxes);
+}
+
+void motion_detect_filter::draw_regions(const frame_view& frame) const noexcept
+{
+    for(size_t i = 0; i < region_count_; ++i)
+    {
+        const auto& r = regions_[i];
+        const auto x0 = r.x0 * block_size_;
+        const auto y0 = r.y0 * block_size_;
+        const auto x1 = (r.x1 + 1) * block_size_ - 1;
+        const auto y1 = (r.y1 + 1) * block_size_ - 1;
+        for(uint32_t x = x0; x <= x1; ++x)
+        {
+            std::memset(frame.row(y0) + size_t(x) * frame.channels, 255, frame.channels);
+            std::memset(frame.row(y1) + size_t(x) * frame.channels, 255, frame.channels);
+        }
+        for(uint32_t y = y0; y <= y1; ++y)
+        {
+            std::memset(frame.row(y) + size_t(x0) * frame.channels, 255, frame.channels);
+            std::memset(frame.row(y) + size_t(x1) * frame.channels, 255, frame.channels);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "async_logger.hpp"
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Block-based motion detector. Keeps a running background of mean luma per
+// `block_size` x `block_size` block (sampling every second row of a block),
+// marks blocks whose mean differs from the background by more than
+// `threshold` (blocks moving for `absorb_frames` become background), groups marked blocks into connected regions and reports motion
+// start, ongoing motion and motion end with region bounding boxes through the log.
+class motion_detect_filter final : public filter
+{
+public:
+    motion_detect_filter(const nlohmann::json& config, const filter_context& context);
+
+    void apply(const frame_view& frame, stripe_pool& pool) override;
+
+private:
+    struct region
+    {
+        uint32_t x0, y0, x1, y1; // block coordinates, inclusive
+        uint32_t blocks;
+    };
+
+    static constexpr size_t MAX_REGIONS = 8;
+
+    bool prepare(const frame_view& frame);
+
+    // block means of one row of blocks, background update and motion mask
+    void update_row(const frame_view& frame, uint32_t by, bool primed) noexcept;
+
+    // groups moving blocks into 4-connected regions, keeping the largest ones
+    void find_regions() noexcept;
+
+    void report(async_logger::site& site, const char* event);
+
+    void draw_regions(const frame_view& frame) const noexcept;
+
+    const std::string stream_id_;
+    async_logger& logger_;
+    async_logger::site start_log_;
+    async_logger::site update_log_;
+    async_logger::site end_log_;
+
+    uint32_t block_size_ = 16;
+    int32_t learning_rate_ = 0;
+    int32_t threshold_ = 0;
+    uint32_t min_blocks_ = 0;
+    uint32_t hold_frames_ = 0;
+    uint32_t absorb_frames_ = 0;
+    bool draw_ = false;
+
+    uint32_t columns_ = 0;
+    uint32_t rows_ = 0;
+    uint32_t channels_ = 0;
+    std::vector<uint32_t> sums_;
+    std::vector<uint16_t> background_; // 8.8 fixed-point mean luma
+    std::vector<uint8_t> mask_;
+    std::vector<uint32_t> motion_age_;
+    std::vector<uint8_t> labels_;
+    std::vector<uint32_t> stack_;
+    region regions_[MAX_REGIONS];
+    size_t region_count_ = 0;
+    uint32_t idle_frames_ = 0;
+    uint32_t motion_frames_ = 0;
+};
@@ -0,0 +1,226 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "perf_counters.hpp"
+
+// std
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "allocation_check.hpp"
+
+void perf_counters::start()
+{
+    std::string missing;
+    for(size_t i = 0; i < EVENTS; ++i)
+    {
+        const auto fd = open_event(i, -1);
+        if(fd < 0)
+        {
+            const auto reason = fd == -ENOSYS ? std::string("not supported on this platform") : std::strerror(-fd);
+            if(i == CYCLES)
+            {
+                iff::log(iff::log_level::warning, "imagefiltercpp", "Performance counters are not available (" + reason + "), see perf_event_paranoid in proc(5)");
+                return;
+            }
+            missing += std::string(missing.empty() ? "" : ", ") + EVENT_NAMES[i] + " (" + reason + ")";
+            continue;
+        }
+        close_event(fd);
+        available_[i] = true;
+    }
+    if(!missing.empty())
+    {
+        iff::log(iff::log_level::warning, "imagefiltercpp", "Performance counters not counted: " + missing);
+    }
+    instance_.store(this, std::memory_order_release);
+}
+
+void perf_counters::stop()
+{
+    if(instance() != this)
+    {
+        return;
+    }
+    instance_.store(nullptr, std::memory_order_release);
+
+    struct summary
+    {
+        std::string stream;
+        std::string name;
+        uint64_t frames = 0;
+        uint64_t pixels = 0;
+        uint64_t values[EVENTS] = {};
+        uint64_t enabled = 0;
+        uint64_t running = 0;
+    };
+    std::vector<summary> summaries;
+    uint64_t overflows = 0;
+    std::scoped_lock<std::mutex> lock(threads_mutex_);
+    for(const auto& t : threads_)
+    {
+        overflows += t->overflows.load(std::memory_order_relaxed);
+        const auto size = t->size.load(std::memory_order_acquire);
+        for(size_t i = 0; i < size; ++i)
+        {
+            const auto& s = t->stages[i];
+            const auto stream = s.stream.load(std::memory_order_relaxed);
+            const std::string stream_id = stream != nullptr ? stream : "-";
+            const std::string name = s.name.load(std::memory_order_relaxed);
+            auto it = std::find_if(summaries.begin(), summaries.end(), [&](const summary& x){ return x.stream == stream_id && x.name == name; });
+            if(it == summaries.end())
+            {
+                it = summaries.insert(summaries.end(), summary{stream_id, name});
+            }
+            it->frames += s.frames.load(std::memory_order_relaxed);
+            it->pixels += s.pixels.load(std::memory_order_relaxed);
+            for(size_t e = 0; e < EVENTS; ++e)
+            {
+                it->values[e] += s.values[e].load(std::memory_order_relaxed);
+            }
+            it->enabled += s.enabled.load(std::memory_order_relaxed);
+            it->running += s.running.load(std::memory_order_relaxed);
+        }
+    }
+    for(const auto& s : summaries)
+    {
+        std::ostringstream message;
+        message << "Stream `" << s.stream << "` " << s.name << " counters: " << s.frames << " frames, ";
+        const auto per_pixel = [&](size_t e)
+        {
+            if(!available_[e])
+            {
+                message << "n/a";
+            }
+            else if(s.pixels != 0)
+            {
+                message << double(s.values[e]) / double(s.pixels);
+            }
+            else
+            {
+                message << s.values[e] << " total";
+            }
+        };
+        per_pixel(CYCLES);
+        message << " cycles/pixel, IPC ";
+        if(available_[INSTRUCTIONS] && s.values[CYCLES] != 0)
+        {
+            message << double(s.values[INSTRUCTIONS]) / double(s.values[CYCLES]);
+        }
+        else
+        {
+            message << "n/a";
+        }
+        message << ", ";
+        per_pixel(CACHE_MISSES);
+        message << " cache misses/pixel, ";
+        per_pixel(DTLB_MISSES);
+        message << " dTLB misses/pixel";
+        if(s.running < s.enabled)
+        {
+            // the kernel multiplexed the group with other users of the counters
+            message << " (counted " << (100 * s.running / s.enabled) << "% of the time)";
+        }
+        iff::log(iff::log_level::info, "imagefiltercpp", message.str());
+    }
+    if(overflows != 0)
+    {
+        iff::log(iff::log_level::warning, "imagefiltercpp", "Performance counters: " + std::to_string(overflows) + " stages not counted, too many stages per thread");
+    }
+}
+
+int perf_counters::open_event(size_t event, int leader) noexcept
+{
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    switch(event)
+    {
+    case CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case CACHE_MISSES:
+        // last-level cache misses on most CPUs
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    default:
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+    }
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    const auto fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, PERF_FLAG_FD_CLOEXEC));
+    return fd >= 0 ? fd : -errno;
+#else
+    static_cast<void>(event);
+    static_cast<void>(leader);
+    return -ENOSYS;
+#endif
+}
+
+void perf_counters::close_event(int fd) noexcept
+{
+#ifdef __linux__
+    ::close(fd);
+#else
+    static_cast<void>(fd);
+#endif
+}
+
+perf_counters::group* perf_counters::local()
+{
+    if(group_owner_ != this)
+    {
+        const allocation_check::exempt registration; // once per thread
+        thread_totals* totals;
+        {
+            std::scoped_lock<std::mutex> lock(threads_mutex_);
+            totals = threads_.emplace_back(std::make_unique<thread_totals>()).get();
+        }
+        group_ = std::make_unique<group>(available_, *totals);
+        group_owner_ = this;
+    }
+    return group_->fds.empty() ? nullptr : group_.get();
+}
@@ -0,0 +1,269 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "tracer.hpp"
+
+constexpr size_t PERF_STAGES_PER_THREAD = 64;
+
+// Counts cycles, instructions, cache misses and data TLB misses of pipeline
+// stages with Linux perf events. Every thread opens its own event group on its
+// first stage and reads the whole group with one read(2) where a stage begins
+// and ends; stripe workers count for the stage of the `run()` caller. Totals are
+// kept per thread and stage, so counting takes no lock, and logged per stream
+// and stage on `stop()`. Only user-space events of this process are counted,
+// which the usual perf_event_paranoid setting of 2 allows; where perf is not
+// available, `start()` says why and a stage costs one load and a branch.
+class perf_counters
+{
+    enum : size_t { CYCLES, INSTRUCTIONS, CACHE_MISSES, DTLB_MISSES, EVENTS };
+
+    struct sample
+    {
+        uint64_t enabled = 0; // ns the group was enabled and running
+        uint64_t running = 0;
+        uint64_t values[EVENTS] = {};
+    };
+
+    struct group;
+
+public:
+    // counts the enclosing scope as stage `name` of `stream`; `pixels` is the
+    // area of the frame it processed, 0 where the scope helps another thread
+    class stage
+    {
+    public:
+        stage(const char* name, uint64_t pixels, const char* stream = tracer::current().stream) noexcept
+            : counters_(instance())
+            , name_(name)
+            , stream_(stream)
+            , pixels_(pixels)
+            , previous_(std::exchange(current_stage_, name))
+        {
+            if(counters_ != nullptr && name_ != nullptr)
+            {
+                group_ = counters_->local();
+                if(group_ != nullptr && !group_->read(begin_))
+                {
+                    group_ = nullptr;
+                }
+            }
+        }
+
+        ~stage()
+        {
+            current_stage_ = previous_;
+            sample end;
+            if(group_ != nullptr && group_->read(end))
+            {
+                group_->add(name_, stream_, pixels_, begin_, end);
+            }
+        }
+
+        stage(const stage&) = delete;
+        stage& operator=(const stage&) = delete;
+
+    private:
+        perf_counters* const counters_;
+        const char* const name_;
+        const char* const stream_;
+        const uint64_t pixels_;
+        const char* const previous_;
+        group* group_ = nullptr;
+        sample begin_;
+    };
+
+    perf_counters() = default;
+
+    ~perf_counters()
+    {
+        stop();
+    }
+
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    static perf_counters* instance() noexcept
+    {
+        return instance_.load(std::memory_order_acquire);
+    }
+
+    // stage the calling thread is in, nullptr outside of stages
+    static const char* current_stage() noexcept
+    {
+        return current_stage_;
+    }
+
+    // checks which events this machine counts; without cycles nothing is counted
+    void start();
+
+    // logs the totals; stream ids and stage names must still be alive
+    void stop();
+
+private:
+    static constexpr const char* EVENT_NAMES[EVENTS] = {"cycles", "instructions", "cache misses", "dTLB misses"};
+
+    struct stage_totals
+    {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<const char*> stream{nullptr};
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> pixels{0};
+        std::atomic<uint64_t> values[EVENTS] = {};
+        std::atomic<uint64_t> enabled{0};
+        std::atomic<uint64_t> running{0};
+    };
+
+    // written only by its thread
+    struct thread_totals
+    {
+        stage_totals stages[PERF_STAGES_PER_THREAD];
+        std::atomic<size_t> size{0};
+        std::atomic<uint64_t> overflows{0};
+    };
+
+    // event group of one thread
+    struct group
+    {
+        group(const bool (&available)[EVENTS], thread_totals& totals)
+            : totals(totals)
+        {
+            for(size_t i = 0; i < EVENTS; ++i)
+            {
+                if(available[i])
+                {
+                    const auto fd = open_event(i, fds.empty() ? -1 : fds.front());
+                    if(fd >= 0)
+                    {
+                        fds.push_back(fd);
+                        events.push_back(i);
+                    }
+                    else if(i == CYCLES)
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+
+        ~group()
+        {
+            // members first, the leader last
+            for(auto it = fds.rbegin(); it != fds.rend(); ++it)
+            {
+                close_event(*it);
+            }
+        }
+
+        group(const group&) = delete;
+        group& operator=(const group&) = delete;
+
+        bool read(sample& out) const noexcept
+        {
+#ifdef __linux__
+            // layout of PERF_FORMAT_GROUP with both times
+            uint64_t data[3 + EVENTS];
+            const auto bytes = sizeof(uint64_t) * (3 + events.size());
+            if(fds.empty() || ::read(fds.front(), data, bytes) != static_cast<ssize_t>(bytes))
+            {
+                return false;
+            }
+            out.enabled = data[1];
+            out.running = data[2];
+            for(size_t i = 0; i < events.size(); ++i)
+            {
+                out.values[events[i]] = data[3 + i];
+            }
+            return true;
+#else
+            static_cast<void>(out);
+            return false;
+#endif
+        }
+
+        void add(const char* name, const char* stream, uint64_t pixels, const sample& begin, const sample& end) noexcept
+        {
+            const auto size = totals.size.load(std::memory_order_relaxed);
+            size_t i = 0;
+            while(i < size && (totals.stages[i].name.load(std::memory_order_relaxed) != name || totals.stages[i].stream.load(std::memory_order_relaxed) != stream))
+            {
+                ++i;
+            }
+            if(i == size)
+            {
+                if(size == PERF_STAGES_PER_THREAD)
+                {
+                    totals.overflows.store(totals.overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+                totals.stages[i].name.store(name, std::memory_order_relaxed);
+                totals.stages[i].stream.store(stream, std::memory_order_relaxed);
+                totals.size.store(size + 1, std::memory_order_release);
+            }
+            auto& s = totals.stages[i];
+            const auto accumulate = [](std::atomic<uint64_t>& total, uint64_t delta){ total.store(total.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed); };
+            if(pixels != 0)
+            {
+                accumulate(s.frames, 1);
+                accumulate(s.pixels, pixels);
+            }
+            for(const auto e : events)
+            {
+                accumulate(s.values[e], end.values[e] - begin.values[e]);
+            }
+            accumulate(s.enabled, end.enabled - begin.enabled);
+            accumulate(s.running, end.running - begin.running);
+        }
+
+        thread_totals& totals;
+        std::vector<int> fds;     // leader first
+        std::vector<size_t> events; // of `fds`, in group read order
+    };
+
+    // returns the file descriptor or a negated errno
+    static int open_event(size_t event, int leader) noexcept;
+
+    static void close_event(int fd) noexcept;
+
+    // group of the calling thread, opened on its first stage; nullptr if that failed
+    group* local();
+
+    static inline std::atomic<perf_counters*> instance_{nullptr};
+    static inline thread_local const char* current_stage_ = nullptr;
+    static inline thread_local std::unique_ptr<group> group_;
+    static inline thread_local const perf_counters* group_owner_ = nullptr;
+
+    bool available_[EVENTS] = {};
+    std::mutex threads_mutex_;
+    std::vector<std::unique_ptr<thread_totals>> threads_;
+};
@@ -0,0 +1,107 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "pixel_conversion.hpp"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+uint32_t bytes_per_pixel(const std::string& format)
+{
+    if(format == "Mono8")
+    {
+        return 1;
+    }
+    if(format == "RGB8" || format == "BGR8")
+    {
+        return 3;
+    }
+    if(format == "RGBA8" || format == "BGRA8")
+    {
+        return 4;
+    }
+    return 0;
+}
+
+pixel_conversion::pixel_conversion(const std::string& from, const std::string& to)
+    : source_channels_(bytes_per_pixel(from))
+    , channels_(bytes_per_pixel(to))
+{
+    if(source_channels_ == 0 || channels_ == 0)
+    {
+        throw std::runtime_error("cannot convert `" + from + "` to `" + to + "`");
+    }
+    const auto red_index = [](const std::string& format) -> uint32_t { return format.rfind("BGR", 0) == 0 ? 2 : 0; };
+    red_ = red_index(from);
+    for(uint32_t c = 0; c < channels_; ++c)
+    {
+        if(c == 3)
+        {
+            map_[c] = source_channels_ == 4 ? 3 : -1;
+        }
+        else if(source_channels_ == 1)
+        {
+            map_[c] = 0;
+        }
+        else if(channels_ != 1)
+        {
+            // red and blue swap places when exactly one side is BGR
+            map_[c] = static_cast<int8_t>(c == 1 ? 1 : (c == 0) == (red_index(to) == red_) ? 0 : 2);
+        }
+    }
+    luma_ = channels_ == 1 && source_channels_ != 1;
+    identity_ = from == to;
+}
+
+void pixel_conversion::apply(const uint8_t* source, uint8_t* destination, uint32_t width) const noexcept
+{
+    if(identity_)
+    {
+        std::memcpy(destination, source, size_t(width) * channels_);
+        return;
+    }
+    const auto source_channels = source_channels_;
+    if(luma_)
+    {
+        const auto red = red_;
+        const auto blue = 2 - red_;
+        for(uint32_t x = 0; x < width; ++x, source += source_channels)
+        {
+            destination[x] = static_cast<uint8_t>((77 * source[red] + 150 * source[1] + 29 * source[blue] + 128) >> 8);
+        }
+        return;
+    }
+    const auto channels = channels_;
+    int8_t map[4];
+    std::copy(map_, map_ + 4, map);
+    for(uint32_t x = 0; x < width; ++x, source += source_channels, destination += channels)
+    {
+        for(uint32_t c = 0; c < channels; ++c)
+        {
+            destination[c] = map[c] < 0 ? 255 : source[map[c]];
+        }
+    }
+}
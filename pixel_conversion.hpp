@@ -0,0 +1,55 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+
+// Bytes per pixel of an importer `format`, or 0 if CPU filters cannot handle it.
+uint32_t bytes_per_pixel(const std::string& format);
+
+// Converts rows between the 8-bit formats `bytes_per_pixel()` accepts:
+// reorders colour channels, adds opaque or drops alpha, replicates grey or computes luma.
+class pixel_conversion
+{
+public:
+    pixel_conversion(const std::string& from, const std::string& to);
+
+    bool identity() const noexcept
+    {
+        return identity_;
+    }
+
+    void apply(const uint8_t* source, uint8_t* destination, uint32_t width) const noexcept;
+
+private:
+    uint32_t source_channels_;
+    uint32_t channels_;
+    int8_t map_[4] = {0, 1, 2, 3}; // source channel of each destination channel, -1 for opaque alpha
+    uint32_t red_ = 0;             // source red channel, for luma
+    bool luma_ = false;
+    bool identity_ = false;
+};
@@ -0,0 +1,413 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "privacy_mask_filter.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+privacy_mask_filter::privacy_mask_filter(const nlohmann::json& config, const filter_context& context)
+    : channels_(context.channels)
+{
+    const auto mode = config.value("mode", "pixelate");
+    if(mode == "pixelate")
+    {
+        mode_ = mask_mode::pixelate;
+    }
+    else if(mode == "fill")
+    {
+        mode_ = mask_mode::fill;
+    }
+    else if(mode == "blur")
+    {
+        mode_ = mask_mode::blur;
+    }
+    else
+    {
+        throw std::runtime_error("unknown `mode` `" + mode + "`");
+    }
+    block_size_ = config.value("block_size", 16u);
+    if(block_size_ < 2 || block_size_ > 128)
+    {
+        throw std::runtime_error("`block_size` must be in [2, 128]");
+    }
+    radius_ = config.value("radius", 16u);
+    if(radius_ == 0 || radius_ > 64) // keeps horizontal sums within 16 bits
+    {
+        throw std::runtime_error("`radius` must be in [1, 64]");
+    }
+    // black, opaque if there is a fourth channel
+    color_[0] = color_[1] = color_[2] = 0;
+    color_[3] = 255;
+    if(config.contains("color"))
+    {
+        const auto color = config.at("color").get<std::vector<uint32_t>>();
+        if(color.size() != channels_ || std::any_of(color.begin(), color.end(), [](uint32_t value){ return value > 255; }))
+        {
+            throw std::runtime_error("`color` must have one value in [0, 255] per channel");
+        }
+        std::copy(color.begin(), color.end(), color_);
+    }
+    const auto regions = config.value("regions", nlohmann::json::array());
+    if(!regions.is_array() || regions.empty())
+    {
+        throw std::runtime_error("`regions` must be a non-empty array");
+    }
+    for(const auto& region_config : regions)
+    {
+        std::vector<point> polygon;
+        if(region_config.contains("points"))
+        {
+            for(const auto& p : region_config.at("points"))
+            {
+                polygon.push_back({p.at(0).get<double>(), p.at(1).get<double>()});
+            }
+            if(polygon.size() < 3)
+            {
+                throw std::runtime_error("polygon regions need at least 3 `points`");
+            }
+        }
+        else
+        {
+            const auto x = region_config.at("x").get<double>();
+            const auto y = region_config.at("y").get<double>();
+            const auto width = region_config.at("width").get<double>();
+            const auto height = region_config.at("height").get<double>();
+            if(!(width > 0.0 && height > 0.0))
+            {
+                throw std::runtime_error("rectangle regions must not be empty");
+            }
+            polygon = {{x, y}, {x + width, y}, {x + width, y + height}, {x, y + height}};
+        }
+        polygons_.push_back(std::move(polygon));
+    }
+}
+
+void privacy_mask_filter::apply(const frame_view& frame, stripe_pool& pool)
+{
+    if(frame.width != width_ || frame.height != height_ || frame.channels != channels_ || scratch_.size() != pool.concurrency())
+    {
+        rasterize(frame, pool);
+    }
+    switch(mode_)
+    {
+    case mask_mode::fill:
+        pool.run(static_cast<uint32_t>(spans_.size()), [&](uint32_t begin, uint32_t end)
+        {
+            fill(frame, begin, end);
+        });
+        break;
+    case mask_mode::pixelate:
+        pool.run(static_cast<uint32_t>(bands_.size()), [&](uint32_t begin, uint32_t end)
+        {
+            pixelate(frame, begin, end);
+        });
+        break;
+    case mask_mode::blur:
+        // every region is blurred from the unmodified frame before any is written, so overlaps are not blurred twice
+        for(const auto& r : regions_)
+        {
+            blur(frame, pool, r);
+        }
+        for(const auto& r : regions_)
+        {
+            pool.run(static_cast<uint32_t>(r.spans.size()), [&](uint32_t begin, uint32_t end)
+            {
+                write_blurred(frame, r, begin, end);
+            });
+        }
+        break;
+    }
+}
+
+void privacy_mask_filter::rasterize_polygon(const std::vector<point>& polygon, uint32_t width, uint32_t height, std::vector<span>& spans)
+{
+    double top = polygon[0].y;
+    double bottom = polygon[0].y;
+    for(const auto& p : polygon)
+    {
+        top = std::min(top, p.y);
+        bottom = std::max(bottom, p.y);
+    }
+    const auto first = static_cast<uint32_t>(std::clamp(std::ceil(top - 0.5), 0.0, double(height)));
+    const auto last = static_cast<uint32_t>(std::clamp(std::ceil(bottom - 0.5), 0.0, double(height)));
+    std::vector<double> crossings;
+    for(uint32_t y = first; y < last; ++y)
+    {
+        const double centre = y + 0.5;
+        crossings.clear();
+        for(size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+        {
+            const auto& a = polygon[i];
+            const auto& b = polygon[j];
+            if((a.y <= centre) != (b.y <= centre))
+            {
+                crossings.push_back(a.x + (centre - a.y) * (b.x - a.x) / (b.y - a.y));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for(size_t i = 0; i + 1 < crossings.size(); i += 2)
+        {
+            const auto x0 = static_cast<uint32_t>(std::clamp(std::ceil(crossings[i] - 0.5), 0.0, double(width)));
+            const auto x1 = static_cast<uint32_t>(std::clamp(std::ceil(crossings[i + 1] - 0.5), 0.0, double(width)));
+            if(x0 < x1)
+            {
+                spans.push_back({y, x0, x1});
+            }
+        }
+    }
+}
+
+void privacy_mask_filter::rasterize(const frame_view& frame, const stripe_pool& pool)
+{
+    width_ = frame.width;
+    height_ = frame.height;
+    channels_ = frame.channels;
+    regions_.clear();
+    std::vector<span> all;
+    for(const auto& polygon : polygons_)
+    {
+        region r;
+        rasterize_polygon(polygon, width_, height_, r.spans);
+        if(r.spans.empty())
+        {
+            continue;
+        }
+        r.x0 = width_;
+        r.x1 = 0;
+        r.y0 = r.spans.front().y;
+        r.y1 = r.spans.back().y + 1;
+        for(const auto& s : r.spans)
+        {
+            r.x0 = std::min(r.x0, s.x0);
+            r.x1 = std::max(r.x1, s.x1);
+        }
+        all.insert(all.end(), r.spans.begin(), r.spans.end());
+        regions_.push_back(std::move(r));
+    }
+
+    // union of all regions, sorted by row and merged so no pixel is visited twice
+    std::sort(all.begin(), all.end(), [](const span& a, const span& b){ return a.y != b.y ? a.y < b.y : a.x0 < b.x0; });
+    spans_.clear();
+    for(const auto& s : all)
+    {
+        if(!spans_.empty() && spans_.back().y == s.y && s.x0 <= spans_.back().x1)
+        {
+            spans_.back().x1 = std::max(spans_.back().x1, s.x1);
+        }
+        else
+        {
+            spans_.push_back(s);
+        }
+    }
+
+    bands_.clear();
+    for(uint32_t i = 0; i < spans_.size(); ++i)
+    {
+        const auto& s = spans_[i];
+        if(bands_.empty() || spans_[bands_.back().span_begin].y / block_size_ != s.y / block_size_)
+        {
+            bands_.push_back({i, i, s.x0 / block_size_, 0});
+        }
+        auto& b = bands_.back();
+        b.span_end = i + 1;
+        b.block_begin = std::min(b.block_begin, s.x0 / block_size_);
+        b.block_end = std::max(b.block_end, (s.x1 - 1) / block_size_ + 1);
+    }
+    const auto blocks = (width_ + block_size_ - 1) / block_size_;
+    scratch_.resize(pool.concurrency());
+    for(auto& slot : scratch_)
+    {
+        slot.sums.assign(size_t(blocks) * channels_, 0);
+        slot.counts.assign(blocks, 0);
+        slot.means.assign(size_t(blocks) * channels_, 0);
+    }
+
+    size_t window = 0;
+    size_t box = 0;
+    for(auto& r : regions_)
+    {
+        const auto rows = std::min(r.y1 + radius_, height_) - (r.y0 > radius_ ? r.y0 - radius_ : 0);
+        window = std::max(window, size_t(rows) * (r.x1 - r.x0) * channels_);
+        r.blurred = box;
+        box += size_t(r.y1 - r.y0) * (r.x1 - r.x0) * channels_;
+    }
+    horizontal_.assign(mode_ == mask_mode::blur ? window : 0, 0);
+    vertical_.assign(mode_ == mask_mode::blur ? size_t(width_) * channels_ : 0, 0);
+    blurred_.assign(mode_ == mask_mode::blur ? box : 0, 0);
+}
+
+void privacy_mask_filter::fill(const frame_view& frame, uint32_t begin, uint32_t end) const noexcept
+{
+    const auto channels = channels_;
+    const bool uniform = std::all_of(color_ + 1, color_ + channels, [&](uint8_t value){ return value == color_[0]; });
+    for(uint32_t i = begin; i < end; ++i)
+    {
+        const auto& s = spans_[i];
+        uint8_t* const pixels = frame.row(s.y) + size_t(s.x0) * channels;
+        const size_t count = size_t(s.x1 - s.x0) * channels;
+        if(uniform)
+        {
+            std::memset(pixels, color_[0], count);
+            continue;
+        }
+        for(size_t j = 0; j < count; j += channels)
+        {
+            std::memcpy(pixels + j, color_, channels);
+        }
+    }
+}
+
+void privacy_mask_filter::pixelate(const frame_view& frame, uint32_t begin, uint32_t end) noexcept
+{
+    auto& slot = scratch_[stripe_pool::slot()];
+    const auto channels = channels_;
+    const auto block_size = block_size_;
+    for(uint32_t band_index = begin; band_index < end; ++band_index)
+    {
+        const auto& b = bands_[band_index];
+        std::fill(slot.sums.begin() + b.block_begin * channels, slot.sums.begin() + b.block_end * channels, 0);
+        std::fill(slot.counts.begin() + b.block_begin, slot.counts.begin() + b.block_end, 0);
+        // masked pixels of the band are summed per block, then replaced with their block's mean
+        for(uint32_t i = b.span_begin; i < b.span_end; ++i)
+        {
+            const auto& s = spans_[i];
+            const uint8_t* pixel = frame.row(s.y) + size_t(s.x0) * channels;
+            for(uint32_t x = s.x0; x < s.x1;)
+            {
+                const auto block = x / block_size;
+                const auto segment_end = std::min(s.x1, (block + 1) * block_size);
+                uint32_t* const sums = slot.sums.data() + block * channels;
+                slot.counts[block] += segment_end - x;
+                for(; x < segment_end; ++x, pixel += channels)
+                {
+                    for(uint32_t c = 0; c < channels; ++c)
+                    {
+                        sums[c] += pixel[c];
+                    }
+                }
+            }
+        }
+        for(uint32_t block = b.block_begin; block < b.block_end; ++block)
+        {
+            const auto count = slot.counts[block];
+            for(uint32_t c = 0; count != 0 && c < channels; ++c)
+            {
+                slot.means[block * channels + c] = static_cast<uint8_t>((slot.sums[block * channels + c] + count / 2) / count);
+            }
+        }
+        for(uint32_t i = b.span_begin; i < b.span_end; ++i)
+        {
+            const auto& s = spans_[i];
+            uint8_t* pixel = frame.row(s.y) + size_t(s.x0) * channels;
+            for(uint32_t x = s.x0; x < s.x1; ++x, pixel += channels)
+            {
+                std::memcpy(pixel, slot.means.data() + (x / block_size) * channels, channels);
+            }
+        }
+    }
+}
+
+void privacy_mask_filter::blur(const frame_view& frame, stripe_pool& pool, const region& r)
+{
+    const auto channels = channels_;
+    const auto radius = radius_;
+    const auto width = r.x1 - r.x0;
+    const auto row_size = size_t(width) * channels;
+    const auto window_begin = r.y0 > radius ? r.y0 - radius : 0;
+    const auto window_end = std::min(r.y1 + radius, height_);
+    const auto last_x = int64_t(frame.width) - 1;
+
+    pool.run(window_end - window_begin, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = window_begin + begin; y < window_begin + end; ++y)
+        {
+            const uint8_t* const source = frame.row(y);
+            uint16_t* const destination = horizontal_.data() + (y - window_begin) * row_size;
+            const auto sample = [&](int64_t x, uint32_t c){ return source[std::clamp<int64_t>(x, 0, last_x) * channels + c]; };
+            for(uint32_t c = 0; c < channels; ++c)
+            {
+                uint32_t sum = 0;
+                for(int64_t x = int64_t(r.x0) - radius; x <= int64_t(r.x0) + radius; ++x)
+                {
+                    sum += sample(x, c);
+                }
+                for(uint32_t x = r.x0; x < r.x1; ++x)
+                {
+                    destination[(x - r.x0) * channels + c] = static_cast<uint16_t>(sum);
+                    sum += sample(int64_t(x) + radius + 1, c) - sample(int64_t(x) - radius, c);
+                }
+            }
+        }
+    });
+
+    const float scale = 1.0f / float((2 * radius + 1) * (2 * radius + 1));
+    pool.run(width, [&](uint32_t begin, uint32_t end)
+    {
+        const auto first = size_t(begin) * channels;
+        const auto count = size_t(end - begin) * channels;
+        const auto window_row = [&](int64_t y)
+        {
+            const auto row = std::clamp<int64_t>(y, window_begin, int64_t(window_end) - 1) - window_begin;
+            return horizontal_.data() + size_t(row) * row_size + first;
+        };
+        uint32_t* const sums = vertical_.data() + first;
+        std::fill(sums, sums + count, 0);
+        for(int64_t y = int64_t(r.y0) - radius; y <= int64_t(r.y0) + radius; ++y)
+        {
+            const uint16_t* const row = window_row(y);
+            for(size_t i = 0; i < count; ++i)
+            {
+                sums[i] += row[i];
+            }
+        }
+        for(uint32_t y = r.y0; y < r.y1; ++y)
+        {
+            uint8_t* const output = blurred_.data() + r.blurred + (y - r.y0) * row_size + first;
+            const uint16_t* const entering = window_row(int64_t(y) + radius + 1);
+            const uint16_t* const leaving = window_row(int64_t(y) - radius);
+            for(size_t i = 0; i < count; ++i)
+            {
+                output[i] = static_cast<uint8_t>(float(sums[i]) * scale + 0.5f);
+                sums[i] += entering[i] - leaving[i];
+            }
+        }
+    });
+}
+
+void privacy_mask_filter::write_blurred(const frame_view& frame, const region& r, uint32_t begin, uint32_t end) const noexcept
+{
+    const auto channels = channels_;
+    const auto row_size = size_t(r.x1 - r.x0) * channels;
+    for(uint32_t i = begin; i < end; ++i)
+    {
+        const auto& s = r.spans[i];
+        std::memcpy(frame.row(s.y) + size_t(s.x0) * channels,
+                    blurred_.data() + r.blurred + (s.y - r.y0) * row_size + size_t(s.x0 - r.x0) * channels, size_t(s.x1 - s.x0) * channels);
+    }
+}
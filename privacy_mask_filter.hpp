@@ -0,0 +1,124 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Privacy masking of fixed `regions` (rectangles or polygons) by `pixelate`
+// (mean of each `block_size` block), `fill` with a solid `color`, or `blur`
+// (box blur of `radius`). Regions are rasterized into per-row spans once for
+// the frame geometry, so per-frame work is proportional to the masked area.
+// Only masked pixels are averaged or blurred into the result, but a blur reads
+// up to `radius` pixels around a region.
+class privacy_mask_filter final : public filter
+{
+public:
+    privacy_mask_filter(const nlohmann::json& config, const filter_context& context);
+
+    void apply(const frame_view& frame, stripe_pool& pool) override;
+
+private:
+    enum class mask_mode
+    {
+        pixelate,
+        fill,
+        blur
+    };
+
+    struct point
+    {
+        double x, y;
+    };
+
+    // pixels [x0, x1) of row y
+    struct span
+    {
+        uint32_t y, x0, x1;
+    };
+
+    // rows of `block_size` with spans [span_begin, span_end) and block columns [block_begin, block_end)
+    struct band
+    {
+        uint32_t span_begin, span_end;
+        uint32_t block_begin, block_end;
+    };
+
+    // spans of one polygon and their bounding box, for `blur`
+    struct region
+    {
+        std::vector<span> spans;
+        uint32_t x0, y0, x1, y1;
+        size_t blurred; // offset of the blurred bounding box in `blurred_`
+    };
+
+    struct scratch
+    {
+        std::vector<uint32_t> sums;   // per block column and channel
+        std::vector<uint32_t> counts; // per block column
+        std::vector<uint8_t> means;
+    };
+
+    // Even-odd rule at pixel centres; a pixel is masked when its centre is inside.
+    static void rasterize_polygon(const std::vector<point>& polygon, uint32_t width, uint32_t height, std::vector<span>& spans);
+
+    void rasterize(const frame_view& frame, const stripe_pool& pool);
+
+    void fill(const frame_view& frame, uint32_t begin, uint32_t end) const noexcept;
+
+    void pixelate(const frame_view& frame, uint32_t begin, uint32_t end) noexcept;
+
+    // Separable box blur of the bounding box of a region into `blurred_` using
+    // running sums, with borders replicated at the frame edges.
+    void blur(const frame_view& frame, stripe_pool& pool, const region& r);
+
+    void write_blurred(const frame_view& frame, const region& r, uint32_t begin, uint32_t end) const noexcept;
+
+    mask_mode mode_ = mask_mode::pixelate;
+    uint32_t block_size_ = 0;
+    uint32_t radius_ = 0;
+    uint8_t color_[4];
+    std::vector<std::vector<point>> polygons_;
+
+    // derived from the polygons for the current frame geometry
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t channels_ = 0;
+    std::vector<region> regions_;
+    std::vector<span> spans_;
+    std::vector<band> bands_;
+    std::vector<scratch> scratch_;
+    std::vector<uint16_t> horizontal_; // horizontally summed rows of the blur window
+    std::vector<uint32_t> vertical_;   // running column sums
+    std::vector<uint8_t> blurred_;
+};
@@ -0,0 +1,40 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// USDT probes of provider `imagefiltercpp` for bpftrace and other eBPF tools;
+// each is a single nop until a tool attaches to it
+#if defined(IFF_USDT_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define IFF_PROBE4(name, a1, a2, a3, a4) DTRACE_PROBE4(imagefiltercpp, name, a1, a2, a3, a4)
+#define IFF_PROBE5(name, a1, a2, a3, a4, a5) DTRACE_PROBE5(imagefiltercpp, name, a1, a2, a3, a4, a5)
+#endif
+#endif
+#ifndef IFF_PROBE4
+// arguments stay unevaluated
+#define IFF_PROBE4(name, a1, a2, a3, a4) static_cast<void>(sizeof((a1, a2, a3, a4)))
+#define IFF_PROBE5(name, a1, a2, a3, a4, a5) static_cast<void>(sizeof((a1, a2, a3, a4, a5)))
+#endif
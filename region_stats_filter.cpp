@@ -0,0 +1,99 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "region_stats_filter.hpp"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+region_stats_filter::region_stats_filter(const nlohmann::json& config, const filter_context& context)
+    : stream_id_(context.stream_id)
+    , logger_(context.logger)
+    , log_(context.logger, "Stream `" + context.stream_id + "` region stats", std::chrono::nanoseconds(0))
+    , integral_(context.integral)
+{
+    context.integral.request();
+    interval_ = config.value("interval", 30u);
+    if(interval_ == 0)
+    {
+        throw std::runtime_error("`interval` must be positive");
+    }
+    const auto regions = config.value("regions", nlohmann::json::array());
+    if(!regions.is_array() || regions.empty())
+    {
+        throw std::runtime_error("`regions` must be a non-empty array");
+    }
+    for(const auto& region_config : regions)
+    {
+        region r;
+        r.name = region_config.value("name", "region" + std::to_string(regions_.size()));
+        r.x = region_config.at("x").get<uint32_t>();
+        r.y = region_config.at("y").get<uint32_t>();
+        r.width = region_config.at("width").get<uint32_t>();
+        r.height = region_config.at("height").get<uint32_t>();
+        if(r.width == 0 || r.height == 0)
+        {
+            throw std::runtime_error("region `" + r.name + "` must not be empty");
+        }
+        regions_.push_back(std::move(r));
+    }
+}
+
+void region_stats_filter::apply(const frame_view&, stripe_pool&)
+{
+    if(++frames_ % interval_ != 0)
+    {
+        return;
+    }
+    char text[LOG_MESSAGE_SIZE];
+    size_t length = 0;
+    for(const auto& r : regions_)
+    {
+        // regions are clipped to the frame
+        if(r.x >= integral_.width() || r.y >= integral_.height() || length >= sizeof(text))
+        {
+            continue;
+        }
+        const auto width = std::min(r.width, integral_.width() - r.x);
+        const auto height = std::min(r.height, integral_.height() - r.y);
+        const auto written = std::snprintf(text + length, sizeof(text) - length, " %s: mean %.1f stddev %.1f;", r.name.c_str(),
+                                           integral_.mean(r.x, r.y, width, height), std::sqrt(integral_.variance(r.x, r.y, width, height)));
+        if(written < 0)
+        {
+            break;
+        }
+        length += static_cast<size_t>(written);
+    }
+    text[std::min(length, sizeof(text) - 1)] = '\0';
+    logger_.log(log_, iff::log_level::info, "Stream `%s` luma statistics:%s", stream_id_.c_str(), text);
+}
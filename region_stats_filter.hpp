@@ -0,0 +1,69 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "async_logger.hpp"
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "integral_image.hpp"
+#include "stripe_pool.hpp"
+
+// Reports mean and standard deviation of luma in configured rectangles, once per `interval` frames.
+class region_stats_filter final : public filter
+{
+public:
+    region_stats_filter(const nlohmann::json& config, const filter_context& context);
+
+    // statistics are only taken every `interval` frames
+    bool reads_integral() const noexcept override
+    {
+        return (frames_ + 1) % interval_ == 0;
+    }
+
+    void apply(const frame_view&, stripe_pool&) override;
+
+private:
+    struct region
+    {
+        std::string name;
+        uint32_t x, y, width, height;
+    };
+
+    const std::string stream_id_;
+    async_logger& logger_;
+    async_logger::site log_;
+    const integral_image& integral_;
+    uint32_t interval_ = 0;
+    std::vector<region> regions_;
+    uint64_t frames_ = 0;
+};
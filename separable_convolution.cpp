@@ -0,0 +1,205 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "separable_convolution.hpp"
+
+// std
+#include <cmath>
+#include <cstring>
+
+std::vector<int32_t> separable_convolution::gaussian(double sigma, uint32_t radius)
+{
+    std::vector<double> weights(2 * radius + 1);
+    double total = 0.0;
+    for(uint32_t i = 0; i < weights.size(); ++i)
+    {
+        const double x = double(i) - radius;
+        weights[i] = std::exp(-x * x / (2.0 * sigma * sigma));
+        total += weights[i];
+    }
+    return normalize(weights, total);
+}
+
+void separable_convolution::apply(const frame_view& frame, stripe_pool& pool, row_output output)
+{
+    if(identity_)
+    {
+        return;
+    }
+    prepare(frame, pool);
+    const auto row_size = frame.row_size();
+    const auto stripes = pool.stripe_count(frame.height);
+    // rows around each stripe boundary, captured before any stripe writes
+    for(uint32_t stripe = 1; stripe < stripes; ++stripe)
+    {
+        const auto boundary = static_cast<int64_t>(stripe_pool::stripe_begin(frame.height, stripes, stripe));
+        for(uint32_t i = 0; i < 2 * radius_; ++i)
+        {
+            const auto y = clamp_row(boundary - radius_ + i, frame.height);
+            std::memcpy(halo_row(stripe, i, row_size), frame.row(y), row_size);
+        }
+    }
+    pool.run(frame.height, [&](uint32_t begin, uint32_t end)
+    {
+        run_stripe(frame, stripes, begin, end, output);
+    });
+}
+
+std::vector<int32_t> separable_convolution::normalize(const std::vector<double>& weights, double total)
+{
+    std::vector<int32_t> kernel(weights.size());
+    int32_t sum = 0;
+    for(size_t i = 0; i < weights.size(); ++i)
+    {
+        kernel[i] = static_cast<int32_t>(weights[i] / total * 256.0 + 0.5);
+        sum += kernel[i];
+    }
+    kernel[kernel.size() / 2] += 256 - sum;
+    return kernel;
+}
+
+void separable_convolution::prepare(const frame_view& frame, const stripe_pool& pool)
+{
+    const auto row_size = frame.row_size();
+    if(row_size == row_size_ && frame.height == height_ && scratch_.size() == pool.concurrency())
+    {
+        return;
+    }
+    row_size_ = row_size;
+    height_ = frame.height;
+    channels_ = frame.channels;
+    scratch_.resize(pool.concurrency());
+    for(auto& slot : scratch_)
+    {
+        slot.padded.assign(row_size + 2 * radius_ * frame.channels, 0);
+        slot.sums.assign(row_size, 0);
+        slot.window.assign((2 * radius_ + 1) * row_size, 0);
+        slot.filtered.assign(row_size, 0);
+    }
+    halo_.assign(pool.concurrency() * 2 * radius_ * row_size, 0);
+}
+
+void separable_convolution::run_stripe(const frame_view& frame, uint32_t stripes, uint32_t begin, uint32_t end, row_output output) noexcept
+{
+    auto& slot = scratch_[stripe_pool::slot()];
+    const auto row_size = frame.row_size();
+    const auto taps = 2 * radius_ + 1;
+    // stripe index is recovered from its first row to locate boundary copies
+    uint32_t stripe = 0;
+    while(stripe_pool::stripe_begin(frame.height, stripes, stripe) != begin)
+    {
+        ++stripe;
+    }
+    const auto source_row = [&](int64_t y) -> const uint8_t*
+    {
+        const auto row = clamp_row(y, frame.height);
+        if(row >= begin && row < end)
+        {
+            return frame.row(row);
+        }
+        if(row < begin)
+        {
+            return halo_row(stripe, row - (begin - radius_), row_size);
+        }
+        return halo_row(stripe + 1, row - (end - radius_), row_size);
+    };
+    const auto window_row = [&](int64_t y)
+    {
+        return slot.window.data() + size_t((y - int64_t(begin) + radius_) % taps) * row_size;
+    };
+
+    for(int64_t y = int64_t(begin) - radius_; y < int64_t(begin) + radius_; ++y)
+    {
+        horizontal(source_row(y), window_row(y), slot, frame.width);
+    }
+    for(uint32_t y = begin; y < end; ++y)
+    {
+        horizontal(source_row(int64_t(y) + radius_), window_row(int64_t(y) + radius_), slot, frame.width);
+        vertical(slot, window_row, y);
+        output(slot.filtered.data(), frame.row(y), row_size);
+    }
+}
+
+void separable_convolution::horizontal(const uint8_t* source, uint16_t* destination, scratch& slot, uint32_t width) const noexcept
+{
+    const auto channels = channels_;
+    const auto row_size = size_t(width) * channels;
+    const auto border = size_t(radius_) * channels;
+    uint8_t* const padded = slot.padded.data();
+    for(size_t i = 0; i < border; i += channels)
+    {
+        std::memcpy(padded + i, source, channels);
+        std::memcpy(padded + border + row_size + i, source + row_size - channels, channels);
+    }
+    std::memcpy(padded + border, source, row_size);
+
+    // taps are accumulated four at a time to limit passes over the row
+    std::fill(destination, destination + row_size, 0);
+    for(size_t k = 0; k < kernel_.size(); k += 4)
+    {
+        const uint16_t w0 = tap_weight(k);
+        const uint16_t w1 = tap_weight(k + 1);
+        const uint16_t w2 = tap_weight(k + 2);
+        const uint16_t w3 = tap_weight(k + 3);
+        const uint8_t* const t0 = padded + tap_index(k) * channels;
+        const uint8_t* const t1 = padded + tap_index(k + 1) * channels;
+        const uint8_t* const t2 = padded + tap_index(k + 2) * channels;
+        const uint8_t* const t3 = padded + tap_index(k + 3) * channels;
+        for(size_t i = 0; i < row_size; ++i)
+        {
+            destination[i] = static_cast<uint16_t>(destination[i] + w0 * t0[i] + w1 * t1[i] + w2 * t2[i] + w3 * t3[i]);
+        }
+    }
+}
+
+template<typename WindowRow>
+void separable_convolution::vertical(scratch& slot, const WindowRow& window_row, uint32_t y) const noexcept
+{
+    const auto row_size = row_size_;
+    uint16_t* const sums = slot.sums.data();
+    std::fill(sums, sums + row_size, 0);
+    const auto tap_row = [&](size_t k){ return window_row(int64_t(y) - radius_ + int64_t(tap_index(k))); };
+    for(size_t k = 0; k < kernel_.size(); k += 4)
+    {
+        // weights scaled to 8.8 so that each product is a 16-bit multiply-high
+        const uint16_t w0 = static_cast<uint16_t>(tap_weight(k) << 8);
+        const uint16_t w1 = static_cast<uint16_t>(tap_weight(k + 1) << 8);
+        const uint16_t w2 = static_cast<uint16_t>(tap_weight(k + 2) << 8);
+        const uint16_t w3 = static_cast<uint16_t>(tap_weight(k + 3) << 8);
+        const uint16_t* const r0 = tap_row(k);
+        const uint16_t* const r1 = tap_row(k + 1);
+        const uint16_t* const r2 = tap_row(k + 2);
+        const uint16_t* const r3 = tap_row(k + 3);
+        for(size_t i = 0; i < row_size; ++i)
+        {
+            sums[i] = static_cast<uint16_t>(sums[i] + ((uint32_t(r0[i]) * w0) >> 16) + ((uint32_t(r1[i]) * w1) >> 16)
+                                                    + ((uint32_t(r2[i]) * w2) >> 16) + ((uint32_t(r3[i]) * w3) >> 16));
+        }
+    }
+    uint8_t* const filtered = slot.filtered.data();
+    for(size_t i = 0; i < row_size; ++i)
+    {
+        filtered[i] = static_cast<uint8_t>((sums[i] + 128) >> 8);
+    }
+}
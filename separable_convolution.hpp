@@ -0,0 +1,118 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Separable convolution of interleaved 8-bit frames with a symmetric
+// non-negative kernel whose weights sum to 256, done in place. Each stripe runs
+// a horizontal pass per source row into a ring of 2 * radius + 1 cached rows
+// and a vertical pass over that rolling window, so every source row is read once.
+// Both passes use 16-bit fixed point (pixel value * 256), which maps to 8 lanes
+// per 128-bit vector even on SSE2. Borders replicate edge pixels. Source rows a stripe needs
+// from its neighbours are copied aside before the stripes start, as neighbours
+// overwrite them. A kernel that collapses to its centre tap (e.g. a Gaussian of very
+// small sigma) is the identity and leaves the frame untouched.
+class separable_convolution
+{
+public:
+    // receives convolved row (`count` samples) and the destination row that still holds the source;
+    // not called for an identity kernel, so it must leave the row unchanged when filtered equals source
+    using row_output = function_ref<void(const uint8_t* filtered, uint8_t* destination, size_t count)>;
+
+    explicit separable_convolution(std::vector<int32_t> kernel)
+        : kernel_(std::move(kernel))
+        , radius_(static_cast<uint32_t>(kernel_.size() / 2))
+        , identity_(kernel_[radius_] == 256)
+    {
+    }
+
+    static std::vector<int32_t> gaussian(double sigma, uint32_t radius);
+
+    static std::vector<int32_t> box(uint32_t radius)
+    {
+        return normalize(std::vector<double>(2 * radius + 1, 1.0), 2.0 * radius + 1.0);
+    }
+
+    void apply(const frame_view& frame, stripe_pool& pool, row_output output);
+
+private:
+    struct scratch
+    {
+        std::vector<uint8_t> padded;   // source row with replicated borders
+        std::vector<uint16_t> sums;
+        std::vector<uint16_t> window;  // (2 * radius + 1) horizontally filtered rows
+        std::vector<uint8_t> filtered;
+    };
+
+    static std::vector<int32_t> normalize(const std::vector<double>& weights, double total);
+
+    static uint32_t clamp_row(int64_t y, uint32_t height) noexcept
+    {
+        return static_cast<uint32_t>(std::clamp<int64_t>(y, 0, int64_t(height) - 1));
+    }
+
+    uint8_t* halo_row(uint32_t boundary, uint32_t index, size_t row_size) noexcept
+    {
+        return halo_.data() + ((size_t(boundary) * 2 * radius_) + index) * row_size;
+    }
+
+    void prepare(const frame_view& frame, const stripe_pool& pool);
+
+    void run_stripe(const frame_view& frame, uint32_t stripes, uint32_t begin, uint32_t end, row_output output) noexcept;
+
+    void horizontal(const uint8_t* source, uint16_t* destination, scratch& slot, uint32_t width) const noexcept;
+
+    template<typename WindowRow>
+    void vertical(scratch& slot, const WindowRow& window_row, uint32_t y) const noexcept;
+
+    // weight of tap `k`, zero past the end of the kernel
+    uint16_t tap_weight(size_t k) const noexcept
+    {
+        return k < kernel_.size() ? static_cast<uint16_t>(kernel_[k]) : 0;
+    }
+
+    size_t tap_index(size_t k) const noexcept
+    {
+        return std::min(k, kernel_.size() - 1);
+    }
+
+    const std::vector<int32_t> kernel_;
+    const uint32_t radius_;
+    const bool identity_;   // the 8.8 vertical weight of a 256 tap does not fit in 16 bits
+
+    size_t row_size_ = 0;
+    uint32_t height_ = 0;
+    uint32_t channels_ = 0;
+    std::vector<scratch> scratch_;
+    std::vector<uint8_t> halo_;
+};
@@ -0,0 +1,184 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "stream.hpp"
+
+// std
+#include <sstream>
+
+stream::stream(stream_config&& config, const std::map<std::string, std::shared_ptr<iff::chain>>& chains, async_logger& logger)
+    : id(config.id)
+    , export_chain(chains.at(config.exporter.chain))
+    , exporter(config.exporter.element)
+    , importer{chains.at(config.importer.chain), config.importer.element}
+    , pacer(config.pacing.fps > 0.0 ? std::make_unique<frame_pacer>(config.pacing, config.id, logger) : nullptr)
+    , frame_rate(config.frame_rate.fps > 0.0 ? std::make_unique<frame_rate_converter>(config.frame_rate, importer, config.id, logger) : nullptr)
+    , demand(!config.demand.monitor.chain.empty() ? std::make_unique<demand_tracker>(config.demand, chains, config.id, logger) : nullptr)
+    , spin_budget(config.wait == wait_strategy::spin_then_park ? config.spin_budget : std::chrono::microseconds(0))
+    , latency_budget(config.latency_budget)
+    , late(config.late)
+    , channels(config.channels)
+    , orientation(config.rotation, config.flip)
+    , integral(std::move(config.integral))
+    , filters(std::move(config.filters))
+    , filter_names(std::move(config.filter_names))
+    , optional_filters(std::move(config.optional_filters))
+    , scalable_filters(static_cast<size_t>(std::find_if(filters.begin(), filters.end(), [](const auto& f){ return !f->scale_invariant(); }) - filters.begin()))
+    , buffer_size_log(logger, "Stream `" + id + "` import buffer size")
+    , queue_full_log(logger, "Stream `" + id + "` processing queue full")
+    , output_drop_log(logger, "Stream `" + id + "` output frame dropped")
+    , output_size_log(logger, "Stream `" + id + "` output import buffer size")
+{
+    if(config.load_shedding.fps > 0.0)
+    {
+        // levels that would change nothing for this stream are left out
+        auto levels = config.load_shedding.levels;
+        const auto level = [&](degradation d){ return std::find(levels.begin(), levels.end(), d); };
+        // at half resolution, optional filters are already off if that level comes first
+        const bool optional_off = level(degradation::optional_filters) < level(degradation::half_resolution);
+        const auto scalable_end = optional_filters.begin() + static_cast<std::ptrdiff_t>(scalable_filters);
+        const bool scaled_work = optional_off ? std::find(optional_filters.begin(), scalable_end, false) != scalable_end : scalable_filters != 0;
+        const bool any_optional = std::find(optional_filters.begin(), optional_filters.end(), true) != optional_filters.end();
+        levels.erase(std::remove_if(levels.begin(), levels.end(), [&](degradation d)
+        {
+            return (d == degradation::optional_filters && !any_optional) || (d == degradation::half_resolution && !scaled_work);
+        }), levels.end());
+        if(!levels.empty())
+        {
+            shedder = std::make_unique<load_shedder>(config.load_shedding, std::move(levels), id, logger);
+        }
+    }
+    // never resized afterwards: queued buffers point to the import targets
+    outputs.reserve(config.outputs.size());
+    for(const auto& output : config.outputs)
+    {
+        outputs.emplace_back(output, config.format, chains);
+    }
+    full_size_outputs.reserve(outputs.size());
+}
+
+void stream::start_stages()
+{
+    if(pacer)
+    {
+        pacer->start();
+    }
+    if(frame_rate)
+    {
+        frame_rate->start();
+    }
+    if(demand)
+    {
+        if(frame_rate && frame_rate->fill_gaps)
+        {
+            demand->on_change = [&converter = *frame_rate](bool active){ converter.set_idle(!active); };
+        }
+        demand->start();
+    }
+}
+
+void stream::stop_stages()
+{
+    if(pacer)
+    {
+        pacer->stop();
+    }
+    if(frame_rate)
+    {
+        frame_rate->stop();
+    }
+    if(demand)
+    {
+        demand->stop();
+    }
+}
+
+void stream::stop()
+{
+    {
+        std::scoped_lock<std::mutex> lock(mutex);
+        stop_processing = true;
+    }
+    cv.notify_all();
+    processing_thread.join();
+}
+
+void stream::log_statistics() const
+{
+    const auto waits = spin_hits + parks;
+    std::ostringstream message;
+    message << "Stream `" << id << "`: " << frames_processed << " frames processed, "
+            << import_drops << " dropped for lack of import buffers, ";
+    if(latency_budget.count() > 0)
+    {
+        message << late_frames << (late == late_policy::drop ? " dropped" : " fast-pathed") << " past their deadline, ";
+    }
+    message << spin_hits << " spin hits, " << parks << " parks";
+    if(waits != 0)
+    {
+        message << " (" << (100 * spin_hits / waits) << "% of waits ended while spinning)";
+    }
+    iff::log(iff::log_level::info, "imagefiltercpp", message.str());
+    for(const auto& output : outputs)
+    {
+        std::ostringstream output_message;
+        output_message << "Stream `" << id << "` output `" << output.name << "`: " << output.frames << " frames, " << output.drops
+                       << " dropped for lack of import buffers, " << output.too_small << " dropped as buffers were too small";
+        iff::log(iff::log_level::info, "imagefiltercpp", output_message.str());
+    }
+    if(pacer)
+    {
+        std::ostringstream pacer_message;
+        pacer_message << "Stream `" << id << "` pacing: " << pacer->frames << " frames, latency mean "
+                      << (pacer->frames != 0 ? pacer->latency_total.count() / int64_t(pacer->frames) : 0) << " us, max " << pacer->latency_max.count()
+                      << " us, mean depth " << (pacer->frames != 0 ? double(pacer->depth_total) / pacer->frames : 0.0) << " frames, max target depth "
+                      << pacer->max_target << ", " << pacer->underruns << " underruns, " << pacer->overflows << " overflows, " << pacer->trimmed
+                      << " frames trimmed, " << pacer->missed_ticks << " ticks missed";
+        iff::log(iff::log_level::info, "imagefiltercpp", pacer_message.str());
+    }
+    if(frame_rate)
+    {
+        std::ostringstream frame_rate_message;
+        frame_rate_message << "Stream `" << id << "` frame rate: " << frame_rate->decimated << " frames skipped";
+        if(frame_rate->fill_gaps)
+        {
+            frame_rate_message << ", " << frame_rate->repeated << " frames repeated, " << frame_rate->repeat_drops << " repeats dropped for lack of import buffers";
+        }
+        iff::log(iff::log_level::info, "imagefiltercpp", frame_rate_message.str());
+    }
+    if(shedder)
+    {
+        std::ostringstream shedder_message;
+        shedder_message << "Stream `" << id << "` load shedding: " << shedder->changes << " level changes, highest level " << shedder->max_level
+                        << ", " << shedder->skipped << " frames skipped";
+        iff::log(iff::log_level::info, "imagefiltercpp", shedder_message.str());
+    }
+    if(demand)
+    {
+        std::ostringstream demand_message;
+        demand_message << "Stream `" << id << "` demand: " << demand->idle_frames << " frames skipped without consumers, "
+                       << demand->idle_periods << " idle periods, " << std::chrono::duration_cast<std::chrono::seconds>(demand->idle_time).count() << " s idle";
+        iff::log(iff::log_level::info, "imagefiltercpp", demand_message.str());
+    }
+}
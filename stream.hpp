@@ -0,0 +1,170 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "allocation_check.hpp"
+#include "async_logger.hpp"
+#include "demand_tracker.hpp"
+#include "filter.hpp"
+#include "frame_orientation.hpp"
+#include "frame_pacer.hpp"
+#include "frame_rate_converter.hpp"
+#include "frame_scaler.hpp"
+#include "import_buffer.hpp"
+#include "integral_image.hpp"
+#include "load_shedder.hpp"
+#include "mosaic.hpp"
+#include "pixel_conversion.hpp"
+#include "stream_config.hpp"
+
+// Copy of the filtered frames for an additional importer, scaled or converted to its format.
+struct stream_output
+{
+    stream_output(const output_config& config, const std::string& source_format, const std::map<std::string, std::shared_ptr<iff::chain>>& chains)
+        : name(config.importer.chain + "/" + config.importer.element)
+        , importer{chains.at(config.importer.chain), config.importer.element}
+        , width(config.width)
+        , height(config.height)
+        , scale(config.scale)
+        , conversion(source_format, config.format)
+        , channels(bytes_per_pixel(config.format))
+        , scaler(config.method)
+    {
+    }
+
+    // output size for a frame of `frame_width` x `frame_height`
+    std::pair<uint32_t, uint32_t> size(uint32_t frame_width, uint32_t frame_height) const noexcept
+    {
+        if(width != 0)
+        {
+            return {width, height};
+        }
+        return {std::max(1u, static_cast<uint32_t>(frame_width / scale + 0.5)), std::max(1u, static_cast<uint32_t>(frame_height / scale + 0.5))};
+    }
+
+    const std::string name;
+    const import_target importer;
+    const uint32_t width;
+    const uint32_t height;
+    const double scale;
+    const pixel_conversion conversion;
+    const uint32_t channels;
+    frame_scaler scaler;
+    import_buffer pending; // full-size copy being filled
+
+    uint64_t frames = 0;
+    uint64_t drops = 0;     // no free import buffer
+    uint64_t too_small = 0; // import buffer smaller than the frame
+};
+
+class frame_synchronizer;
+
+// Frame path of one export -> import pair. Chain and element handles are
+// resolved once at startup, so per-frame code only dereferences pointers.
+struct stream
+{
+    stream(stream_config&& config, const std::map<std::string, std::shared_ptr<iff::chain>>& chains, async_logger& logger);
+
+    // threads of the pacer, frame rate converter and demand tracker
+    void start_stages();
+
+    void stop_stages();
+
+    // asks the processing thread to stop and waits for it
+    void stop();
+
+    // statistics, logged once the stream and its stages are stopped
+    void log_statistics() const;
+
+    const std::string id;
+    const std::shared_ptr<iff::chain> export_chain;
+    const std::string exporter;
+    const import_target importer;
+    const std::unique_ptr<frame_pacer> pacer; // pushes frames to `importer` when pacing is configured
+    const std::unique_ptr<frame_rate_converter> frame_rate;
+    const std::unique_ptr<demand_tracker> demand; // frames are skipped while nobody consumes the stream
+    const std::chrono::microseconds spin_budget;
+    const std::chrono::microseconds latency_budget;
+    const late_policy late;
+    const uint32_t channels;
+    const frame_orientation orientation;
+    const std::unique_ptr<integral_image> integral;
+    const std::vector<std::unique_ptr<filter>> filters;
+    const std::vector<std::string> filter_names;
+    const std::vector<bool> optional_filters;
+    const size_t scalable_filters; // leading filters that may run at half resolution
+    std::unique_ptr<load_shedder> shedder;
+    frame_scaler shrink{frame_scaler::method::area};        // to and from the half-size copy
+    frame_scaler enlarge{frame_scaler::method::bilinear};
+    std::vector<uint8_t> half_frame;
+    std::vector<stream_output> outputs;
+    std::vector<stream_output*> full_size_outputs; // of the current frame
+    std::vector<mosaic::tile*> mosaic_tiles;
+    frame_synchronizer* synchronizer = nullptr; // holds frames until they can be pushed with those of other streams
+    size_t synchronizer_member = 0;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    frame_queue queue{PROCESSING_QUEUE_CAPACITY};
+    std::atomic<size_t> queued_frames{0}; // mirrors queue size for lock-free spinning
+    std::atomic<bool> stop_processing{false};
+    bool parked = false;                  // processing thread sleeps on `cv`, guarded by `mutex`
+    std::thread processing_thread;
+
+    // processing thread wait statistics
+    uint64_t frames_processed = 0;
+    uint64_t spin_hits = 0;
+    uint64_t parks = 0;
+
+    uint64_t import_drops = 0; // no free buffer in the stream importer, counted by the export callback
+    uint64_t late_frames = 0;  // past their deadline when dequeued
+
+    allocation_check export_allocations{"export callback"};
+    allocation_check processing_allocations{"processing"};
+
+    // rate limited per stream, a storm on one stream does not hide errors of the others
+    async_logger::site buffer_size_log;
+    async_logger::site queue_full_log;
+    async_logger::site output_drop_log;
+    async_logger::site output_size_log;
+};
@@ -0,0 +1,517 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "stream_config.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+#include "pixel_conversion.hpp"
+
+// Resolves "chain/element" reference against `chains` section and checks element type.
+element_ref parse_element_ref(const nlohmann::json& chains_config, const nlohmann::json& value, const std::string& type)
+{
+    if(!value.is_string())
+    {
+        throw std::runtime_error("element reference must be a string in `chain/element` form");
+    }
+    const auto text = value.get<std::string>();
+    const auto separator = text.find('/');
+    if(separator == std::string::npos)
+    {
+        throw std::runtime_error("element reference `" + text + "` must be in `chain/element` form");
+    }
+    element_ref ref{text.substr(0, separator), text.substr(separator + 1), {}};
+    for(const auto& chain_config : chains_config)
+    {
+        if(chain_config.value("id", "") != ref.chain)
+        {
+            continue;
+        }
+        const auto it_elements = chain_config.find("elements");
+        if(it_elements != chain_config.end() && it_elements->is_array())
+        {
+            for(const auto& element_config : *it_elements)
+            {
+                if(element_config.value("id", "") == ref.element)
+                {
+                    if(element_config.value("type", "") != type)
+                    {
+                        throw std::runtime_error("element `" + text + "` must be of type `" + type + "`");
+                    }
+                    ref.config = element_config;
+                    return ref;
+                }
+            }
+        }
+        throw std::runtime_error("element `" + text + "` not found");
+    }
+    throw std::runtime_error("chain `" + ref.chain + "` not found");
+}
+
+std::vector<stream_config> parse_stream_configs(const nlohmann::json& config, const nlohmann::json& chains_config, async_logger& logger)
+{
+    auto streams_config = nlohmann::json::array({{{"id", "main"}, {"export", "export/exporter"}, {"import", "import/importer"}}});
+    const auto it_processing = config.find("processing");
+    if(it_processing != config.end())
+    {
+        if(!it_processing->is_object())
+        {
+            throw std::runtime_error("section `processing` must be an object");
+        }
+        const auto it_streams = it_processing->find("streams");
+        if(it_streams != it_processing->end())
+        {
+            if(!it_streams->is_array() || it_streams->empty())
+            {
+                throw std::runtime_error("section `processing.streams` must be a non-empty array");
+            }
+            streams_config = *it_streams;
+        }
+    }
+
+    std::vector<stream_config> result;
+    for(const auto& stream_json : streams_config)
+    {
+        stream_config stream;
+        stream.id = stream_json.value("id", "");
+        if(stream.id.empty())
+        {
+            throw std::runtime_error("stream must have non-empty `id`");
+        }
+        try
+        {
+            stream.exporter = parse_element_ref(chains_config, stream_json.at("export"), "frame_exporter");
+            stream.importer = parse_element_ref(chains_config, stream_json.at("import"), "frame_importer");
+            const auto strategy = stream_json.value("wait_strategy", "park");
+            if(strategy == "spin_then_park")
+            {
+                stream.wait = wait_strategy::spin_then_park;
+                stream.spin_budget = std::chrono::microseconds(stream_json.value("spin_budget_us", DEFAULT_SPIN_BUDGET.count()));
+                if(stream.spin_budget.count() <= 0)
+                {
+                    throw std::runtime_error("`spin_budget_us` must be positive");
+                }
+            }
+            else if(strategy != "park")
+            {
+                throw std::runtime_error("unknown `wait_strategy` `" + strategy + "`");
+            }
+            else if(stream_json.contains("spin_budget_us"))
+            {
+                throw std::runtime_error("`spin_budget_us` only applies to `wait_strategy` `spin_then_park`");
+            }
+
+            const auto latency_budget = stream_json.value("latency_budget_ms", 0.0);
+            if(!(latency_budget >= 0.0 && latency_budget <= 10000.0))
+            {
+                throw std::runtime_error("`latency_budget_ms` must be in [0, 10000]");
+            }
+            stream.latency_budget = std::chrono::microseconds(static_cast<int64_t>(latency_budget * 1000.0));
+            const auto late = stream_json.value("late_frames", "drop");
+            if(late == "fast")
+            {
+                stream.late = late_policy::fast;
+            }
+            else if(late != "drop")
+            {
+                throw std::runtime_error("unknown `late_frames` `" + late + "`");
+            }
+
+            const auto format = stream.importer.config.value("format", "");
+            stream.format = format;
+            stream.channels = bytes_per_pixel(format);
+            if(stream.channels == 0)
+            {
+                throw std::runtime_error("importer format `" + format + "` is not supported by CPU filters");
+            }
+            stream.rotation = stream_json.value("rotate", 0u);
+            if(stream.rotation % 90 != 0 || stream.rotation >= 360)
+            {
+                throw std::runtime_error("`rotate` must be 0, 90, 180 or 270");
+            }
+            const auto flip = stream_json.value("flip", "none");
+            if(flip == "horizontal")
+            {
+                stream.flip = frame_orientation::flip::horizontal;
+            }
+            else if(flip == "vertical")
+            {
+                stream.flip = frame_orientation::flip::vertical;
+            }
+            else if(flip != "none")
+            {
+                throw std::runtime_error("unknown `flip` `" + flip + "`");
+            }
+            const auto filters_config = stream_json.value("filters", nlohmann::json::array({{{"type", "crosshair"}}}));
+            if(!filters_config.is_array())
+            {
+                throw std::runtime_error("`filters` must be an array");
+            }
+            for(const auto& filter_config : filters_config)
+            {
+                try
+                {
+                    stream.filters.push_back(make_filter(filter_config, filter_context{stream.id, format, stream.channels, logger, *stream.integral}));
+                    stream.filter_names.push_back(filter_config.value("type", ""));
+                    const bool optional = filter_config.value("optional", false);
+                    if(optional && stream.filter_names.back() == "privacy_mask")
+                    {
+                        // skipping it would leak the masked regions
+                        throw std::runtime_error("`optional` is not allowed, the mask must be applied to every frame");
+                    }
+                    stream.optional_filters.push_back(optional);
+                }
+                catch(const std::exception& e)
+                {
+                    throw std::runtime_error("filter `" + filter_config.value("type", "") + "`: " + e.what());
+                }
+            }
+            const auto outputs_config = stream_json.value("outputs", nlohmann::json::array());
+            if(!outputs_config.is_array())
+            {
+                throw std::runtime_error("`outputs` must be an array");
+            }
+            for(const auto& output_json : outputs_config)
+            {
+                output_config output;
+                try
+                {
+                    output.importer = parse_element_ref(chains_config, output_json.at("import"), "frame_importer");
+                    if(output.importer.chain == stream.importer.chain && output.importer.element == stream.importer.element)
+                    {
+                        throw std::runtime_error("must not be the stream importer");
+                    }
+                    output.format = output.importer.config.value("format", "");
+                    pixel_conversion(format, output.format); // throws if not convertible
+                    const auto method = output_json.value("method", "area");
+                    if(method == "bilinear")
+                    {
+                        output.method = frame_scaler::method::bilinear;
+                    }
+                    else if(method != "area")
+                    {
+                        throw std::runtime_error("unknown `method` `" + method + "`");
+                    }
+                    if(output_json.contains("width") || output_json.contains("height"))
+                    {
+                        output.width = output_json.at("width").get<uint32_t>();
+                        output.height = output_json.at("height").get<uint32_t>();
+                        if(output.width == 0 || output.height == 0)
+                        {
+                            throw std::runtime_error("`width` and `height` must be positive");
+                        }
+                    }
+                    else
+                    {
+                        output.scale = output_json.value("scale", 2.0);
+                        if(!(output.scale >= 1.0 && output.scale <= 16.0))
+                        {
+                            throw std::runtime_error("`scale` must be in [1, 16]");
+                        }
+                    }
+                    if(output.format != format && (output.width != 0 || output.scale != 1.0))
+                    {
+                        throw std::runtime_error("importer format must be `" + format + "` like the stream importer unless `scale` is 1");
+                    }
+                }
+                catch(const std::exception& e)
+                {
+                    throw std::runtime_error("output `" + output_json.value("import", "") + "`: " + e.what());
+                }
+                stream.outputs.push_back(std::move(output));
+            }
+            const auto it_pacing = stream_json.find("pacing");
+            if(it_pacing != stream_json.end())
+            {
+                stream.pacing.fps = it_pacing->at("fps").get<double>();
+                if(!(stream.pacing.fps > 0.0 && stream.pacing.fps <= 240.0))
+                {
+                    throw std::runtime_error("pacing `fps` must be in (0, 240]");
+                }
+                stream.pacing.min_depth = it_pacing->value("min_depth", 1u);
+                stream.pacing.max_depth = it_pacing->value("max_depth", std::max(4u, stream.pacing.min_depth));
+                if(stream.pacing.min_depth == 0 || stream.pacing.max_depth < stream.pacing.min_depth || stream.pacing.max_depth > 16)
+                {
+                    throw std::runtime_error("pacing must have 1 <= `min_depth` <= `max_depth` <= 16");
+                }
+            }
+            const auto it_frame_rate = stream_json.find("frame_rate");
+            if(it_frame_rate != stream_json.end())
+            {
+                stream.frame_rate.fps = it_frame_rate->at("fps").get<double>();
+                if(!(stream.frame_rate.fps > 0.0 && stream.frame_rate.fps <= 240.0))
+                {
+                    throw std::runtime_error("frame rate `fps` must be in (0, 240]");
+                }
+                stream.frame_rate.fill_gaps = it_frame_rate->value("fill_gaps", false);
+                if(stream.frame_rate.fill_gaps && stream.pacing.fps > 0.0)
+                {
+                    throw std::runtime_error("frame rate `fill_gaps` cannot be combined with `pacing`");
+                }
+            }
+            const auto it_demand = stream_json.find("demand");
+            if(it_demand != stream_json.end())
+            {
+                auto& demand = stream.demand;
+                demand.monitor = parse_element_ref(chains_config, it_demand->at("monitor"), "sub_monitor");
+                demand.idle_timeout = std::chrono::milliseconds(it_demand->value("idle_timeout_ms", 3000u));
+                if(demand.idle_timeout.count() < 100 || demand.idle_timeout.count() > 60000)
+                {
+                    throw std::runtime_error("demand `idle_timeout_ms` must be in [100, 60000]");
+                }
+            }
+            const auto it_shedding = stream_json.find("load_shedding");
+            if(it_shedding != stream_json.end())
+            {
+                auto& shedding = stream.load_shedding;
+                shedding.fps = it_shedding->value("fps", stream.frame_rate.fps > 0.0 ? stream.frame_rate.fps : stream.pacing.fps);
+                if(!(shedding.fps > 0.0 && shedding.fps <= 240.0))
+                {
+                    throw std::runtime_error("load shedding `fps` must be in (0, 240], it has no default without `frame_rate` or `pacing`");
+                }
+                for(const auto& level : it_shedding->value("levels", std::vector<std::string>{"optional_filters", "half_resolution", "skip_frames"}))
+                {
+                    degradation d;
+                    if(level == "optional_filters")
+                    {
+                        d = degradation::optional_filters;
+                    }
+                    else if(level == "half_resolution")
+                    {
+                        d = degradation::half_resolution;
+                    }
+                    else if(level == "skip_frames")
+                    {
+                        d = degradation::skip_frames;
+                    }
+                    else
+                    {
+                        throw std::runtime_error("unknown load shedding level `" + level + "`");
+                    }
+                    if(std::find(shedding.levels.begin(), shedding.levels.end(), d) != shedding.levels.end())
+                    {
+                        throw std::runtime_error("load shedding level `" + level + "` is listed twice");
+                    }
+                    shedding.levels.push_back(d);
+                }
+                shedding.window = it_shedding->value("window", 30u);
+                if(shedding.window < 2 || shedding.window > 1000)
+                {
+                    throw std::runtime_error("load shedding `window` must be in [2, 1000]");
+                }
+                shedding.high = it_shedding->value("high", 0.9);
+                shedding.low = it_shedding->value("low", 0.6);
+                if(!(shedding.low > 0.0 && shedding.low < shedding.high && shedding.high <= 2.0))
+                {
+                    throw std::runtime_error("load shedding must have 0 < `low` < `high` <= 2");
+                }
+            }
+        }
+        catch(const std::exception& e)
+        {
+            throw std::runtime_error("stream `" + stream.id + "`: " + e.what());
+        }
+        for(const auto& other : result)
+        {
+            if(other.id == stream.id)
+            {
+                throw std::runtime_error("duplicate stream id `" + stream.id + "`");
+            }
+            if(other.exporter.chain == stream.exporter.chain && other.exporter.element == stream.exporter.element)
+            {
+                throw std::runtime_error("streams `" + other.id + "` and `" + stream.id + "` use the same exporter");
+            }
+        }
+        result.push_back(std::move(stream));
+    }
+    return result;
+}
+
+std::vector<synchronizer_config> parse_synchronizer_configs(const nlohmann::json& config, const std::vector<stream_config>& streams)
+{
+    std::vector<synchronizer_config> result;
+    const auto it_processing = config.find("processing");
+    if(it_processing == config.end())
+    {
+        return result;
+    }
+    const auto synchronizers_config = it_processing->value("synchronizers", nlohmann::json::array());
+    if(!synchronizers_config.is_array())
+    {
+        throw std::runtime_error("section `processing.synchronizers` must be an array");
+    }
+    for(const auto& synchronizer_json : synchronizers_config)
+    {
+        synchronizer_config synchronizer;
+        synchronizer.id = synchronizer_json.value("id", "");
+        if(synchronizer.id.empty())
+        {
+            throw std::runtime_error("synchronizer must have non-empty `id`");
+        }
+        try
+        {
+            synchronizer.streams = synchronizer_json.at("streams").get<std::vector<std::string>>();
+            if(synchronizer.streams.size() < 2)
+            {
+                throw std::runtime_error("`streams` must list at least two streams");
+            }
+            for(const auto& id : synchronizer.streams)
+            {
+                if(std::none_of(streams.begin(), streams.end(), [&](const stream_config& stream){ return stream.id == id; }))
+                {
+                    throw std::runtime_error("unknown stream `" + id + "`");
+                }
+                if(std::count(synchronizer.streams.begin(), synchronizer.streams.end(), id) != 1)
+                {
+                    throw std::runtime_error("stream `" + id + "` is listed twice");
+                }
+                for(const auto& other : result)
+                {
+                    if(std::find(other.streams.begin(), other.streams.end(), id) != other.streams.end())
+                    {
+                        throw std::runtime_error("stream `" + id + "` already belongs to synchronizer `" + other.id + "`");
+                    }
+                }
+            }
+            synchronizer.tolerance = synchronizer_json.at("tolerance").get<uint64_t>();
+            synchronizer.window = synchronizer_json.value("window", 4u);
+            if(synchronizer.window == 0 || synchronizer.window > PROCESSING_QUEUE_CAPACITY)
+            {
+                throw std::runtime_error("`window` must be in [1, " + std::to_string(PROCESSING_QUEUE_CAPACITY) + "]");
+            }
+        }
+        catch(const std::exception& e)
+        {
+            throw std::runtime_error("synchronizer `" + synchronizer.id + "`: " + e.what());
+        }
+        for(const auto& other : result)
+        {
+            if(other.id == synchronizer.id)
+            {
+                throw std::runtime_error("duplicate synchronizer id `" + synchronizer.id + "`");
+            }
+        }
+        result.push_back(std::move(synchronizer));
+    }
+    return result;
+}
+
+std::vector<mosaic_config> parse_mosaic_configs(const nlohmann::json& config, const nlohmann::json& chains_config, const std::vector<stream_config>& streams)
+{
+    std::vector<mosaic_config> result;
+    const auto it_processing = config.find("processing");
+    if(it_processing == config.end())
+    {
+        return result;
+    }
+    const auto mosaics_config = it_processing->value("mosaics", nlohmann::json::array());
+    if(!mosaics_config.is_array())
+    {
+        throw std::runtime_error("section `processing.mosaics` must be an array");
+    }
+    for(const auto& mosaic_json : mosaics_config)
+    {
+        mosaic_config mosaic;
+        mosaic.id = mosaic_json.value("id", "");
+        if(mosaic.id.empty())
+        {
+            throw std::runtime_error("mosaic must have non-empty `id`");
+        }
+        try
+        {
+            mosaic.importer = parse_element_ref(chains_config, mosaic_json.at("import"), "frame_importer");
+            const auto format = mosaic.importer.config.value("format", "");
+            mosaic.channels = bytes_per_pixel(format);
+            if(mosaic.channels == 0)
+            {
+                throw std::runtime_error("importer format `" + format + "` is not supported by CPU filters");
+            }
+            mosaic.width = mosaic_json.at("width").get<uint32_t>();
+            mosaic.height = mosaic_json.at("height").get<uint32_t>();
+            mosaic.tiles = mosaic_json.at("tiles").get<std::vector<std::string>>();
+            if(mosaic.tiles.empty())
+            {
+                throw std::runtime_error("`tiles` must not be empty");
+            }
+            mosaic.columns = mosaic_json.value("columns", static_cast<uint32_t>(std::ceil(std::sqrt(double(mosaic.tiles.size())))));
+            mosaic.rows = mosaic_json.value("rows", mosaic.columns != 0 ? static_cast<uint32_t>((mosaic.tiles.size() + mosaic.columns - 1) / mosaic.columns) : 0);
+            if(mosaic.columns == 0 || mosaic.rows == 0 || mosaic.tiles.size() > size_t(mosaic.columns) * mosaic.rows)
+            {
+                throw std::runtime_error("`tiles` do not fit into `columns` x `rows`");
+            }
+            if(mosaic.width < mosaic.columns || mosaic.height < mosaic.rows)
+            {
+                throw std::runtime_error("`width` and `height` are too small for the grid");
+            }
+            mosaic.fps = mosaic_json.value("fps", 25.0);
+            if(!(mosaic.fps > 0.0 && mosaic.fps <= 240.0))
+            {
+                throw std::runtime_error("`fps` must be in (0, 240]");
+            }
+            const auto method = mosaic_json.value("method", "area");
+            if(method == "bilinear")
+            {
+                mosaic.method = frame_scaler::method::bilinear;
+            }
+            else if(method != "area")
+            {
+                throw std::runtime_error("unknown `method` `" + method + "`");
+            }
+            for(const auto& tile : mosaic.tiles)
+            {
+                if(tile.empty())
+                {
+                    continue;
+                }
+                const auto it_stream = std::find_if(streams.begin(), streams.end(), [&](const stream_config& stream){ return stream.id == tile; });
+                if(it_stream == streams.end())
+                {
+                    throw std::runtime_error("unknown stream `" + tile + "`");
+                }
+                if(it_stream->format != format)
+                {
+                    throw std::runtime_error("stream `" + tile + "` importer format must be `" + format + "` like the mosaic importer");
+                }
+            }
+        }
+        catch(const std::exception& e)
+        {
+            throw std::runtime_error("mosaic `" + mosaic.id + "`: " + e.what());
+        }
+        for(const auto& other : result)
+        {
+            if(other.id == mosaic.id)
+            {
+                throw std::runtime_error("duplicate mosaic id `" + mosaic.id + "`");
+            }
+        }
+        result.push_back(std::move(mosaic));
+    }
+    return result;
+}
@@ -0,0 +1,172 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "async_logger.hpp"
+#include "filter.hpp"
+#include "frame_orientation.hpp"
+#include "frame_scaler.hpp"
+#include "integral_image.hpp"
+
+constexpr size_t PROCESSING_QUEUE_CAPACITY = 32;
+constexpr auto DEFAULT_SPIN_BUDGET = std::chrono::microseconds(50);
+
+// what the processing thread does with a frame that is already past its deadline
+enum class late_policy
+{
+    drop, // release it without filtering or pushing
+    fast, // filter it without optional filters
+};
+
+enum class wait_strategy
+{
+    park,           // always sleep on the condition variable
+    spin_then_park, // busy-wait for up to the spin budget first
+};
+
+struct element_ref
+{
+    std::string chain;
+    std::string element;
+    nlohmann::json config;
+};
+
+// additional importer receiving a copy of the filtered frames
+struct output_config
+{
+    element_ref importer;
+    std::string format;
+    frame_scaler::method method = frame_scaler::method::area;
+    uint32_t width = 0; // fixed size, or 0 to divide the frame size by `scale`
+    uint32_t height = 0;
+    double scale = 1.0;
+};
+
+// releases frames to the stream importer at a fixed rate, disabled when `fps` is 0
+struct pacing_config
+{
+    double fps = 0.0;
+    uint32_t min_depth = 1; // frames buffered before playback starts
+    uint32_t max_depth = 4;
+};
+
+// output frame rate of a stream, unchanged when `fps` is 0
+struct frame_rate_config
+{
+    double fps = 0.0;
+    bool fill_gaps = false; // repeat the last frame when the input is slower
+};
+
+// consumer presence check of a stream, disabled when `monitor` is not set
+struct demand_config
+{
+    element_ref monitor;
+    std::chrono::milliseconds idle_timeout{3000}; // without frames taken by the importer
+};
+
+// ways to reduce the filter time of a stream, in the order they are tried
+enum class degradation
+{
+    optional_filters, // filters marked `optional` are not applied
+    half_resolution,  // leading scale-invariant filters run on a half-size copy
+    skip_frames,      // every other frame is dropped before it is copied
+};
+
+// filter time control of a stream, disabled when `fps` is 0
+struct load_shedding_config
+{
+    double fps = 0.0; // frame budget is 1 / fps
+    std::vector<degradation> levels;
+    uint32_t window = 30; // frames averaged
+    double high = 0.9;    // fractions of the budget
+    double low = 0.6;
+};
+
+struct stream_config
+{
+    std::string id;
+    element_ref exporter;
+    element_ref importer;
+    wait_strategy wait = wait_strategy::park;
+    std::chrono::microseconds spin_budget{0};
+    std::chrono::microseconds latency_budget{0}; // from receiving a frame to its deadline, 0 for none
+    late_policy late = late_policy::drop;
+    std::string format; // of the importer
+    uint32_t channels = 0;
+    uint32_t rotation = 0;
+    frame_orientation::flip flip = frame_orientation::flip::none;
+    std::unique_ptr<integral_image> integral = std::make_unique<integral_image>();
+    std::vector<std::unique_ptr<filter>> filters;
+    std::vector<std::string> filter_names; // types, for traces
+    std::vector<bool> optional_filters;    // may be disabled by load shedding
+    std::vector<output_config> outputs;
+    pacing_config pacing;
+    frame_rate_config frame_rate;
+    demand_config demand;
+    load_shedding_config load_shedding;
+};
+
+// `processing.mosaics` entry: filtered frames of several streams tiled into the frames of one importer
+struct mosaic_config
+{
+    std::string id;
+    element_ref importer;
+    uint32_t channels = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t columns = 0;
+    uint32_t rows = 0;
+    double fps = 0.0;
+    frame_scaler::method method = frame_scaler::method::area;
+    std::vector<std::string> tiles; // stream ids in row-major order, empty for unused cells
+};
+
+// Parses `processing.streams` section; defaults to a single `export/exporter` -> `import/importer` stream.
+std::vector<stream_config> parse_stream_configs(const nlohmann::json& config, const nlohmann::json& chains_config, async_logger& logger);
+
+// `processing.synchronizers` entry: streams whose frames are released in sets of matching timestamps
+struct synchronizer_config
+{
+    std::string id;
+    std::vector<std::string> streams;
+    uint64_t tolerance = 0; // in `image_metadata::timestamp` units
+    uint32_t window = 0;    // frames held per stream
+};
+
+// Parses optional `processing.synchronizers` section; a stream may belong to one synchronizer.
+std::vector<synchronizer_config> parse_synchronizer_configs(const nlohmann::json& config, const std::vector<stream_config>& streams);
+
+// Parses optional `processing.mosaics` section; tiles refer to streams by id.
+std::vector<mosaic_config> parse_mosaic_configs(const nlohmann::json& config, const nlohmann::json& chains_config, const std::vector<stream_config>& streams);
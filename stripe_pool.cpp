@@ -0,0 +1,127 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "stripe_pool.hpp"
+
+// std
+#include <string>
+
+#include "perf_counters.hpp"
+
+stripe_pool::stripe_pool(size_t threads)
+{
+    for(size_t i = 1; i < threads; ++i)
+    {
+        workers_.emplace_back([this, i]()
+        {
+            slot_ = static_cast<uint32_t>(i);
+            tracer::name_thread("stripe worker " + std::to_string(i));
+            worker_loop();
+        });
+    }
+}
+
+stripe_pool::~stripe_pool()
+{
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    start_cv_.notify_all();
+    for(auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void stripe_pool::run(uint32_t rows, task work)
+{
+    if(rows == 0)
+    {
+        return;
+    }
+    const auto stripes = stripe_count(rows);
+    // single stripes are admitted too, so the deadline order also holds for a one-thread pool
+    const admission admitted(*this);
+    if(stripes == 1)
+    {
+        work(0, rows);
+        return;
+    }
+    {
+        std::scoped_lock<std::mutex> lock(mutex_);
+        task_ = &work;
+        trace_context_ = tracer::current();
+        perf_stage_ = perf_counters::current_stage();
+        count_allocations_ = allocation_check::counting();
+        rows_ = rows;
+        stripes_ = stripes;
+        next_stripe_.store(0, std::memory_order_relaxed);
+        busy_workers_ = workers_.size();
+        ++generation_;
+    }
+    start_cv_.notify_all();
+    run_stripes();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this](){ return busy_workers_ == 0; });
+    task_ = nullptr;
+    // the workers' allocations belong to the caller's frame
+    allocation_check::charge(worker_allocations_.exchange(0, std::memory_order_relaxed));
+}
+
+void stripe_pool::run_stripes()
+{
+    uint32_t stripe;
+    while((stripe = next_stripe_.fetch_add(1, std::memory_order_relaxed)) < stripes_)
+    {
+        const tracer::span trace("stripe", trace_context_);
+        (*task_)(stripe_begin(rows_, stripes_, stripe), stripe_begin(rows_, stripes_, stripe + 1));
+    }
+}
+
+void stripe_pool::worker_loop()
+{
+    uint64_t seen_generation = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while(true)
+    {
+        start_cv_.wait(lock, [&](){ return stop_ || generation_ != seen_generation; });
+        if(stop_)
+        {
+            return;
+        }
+        seen_generation = generation_;
+        lock.unlock();
+        {
+            const perf_counters::stage counted(perf_stage_, 0, trace_context_.stream);
+            const allocation_check::helper_scope counted_allocations(count_allocations_, worker_allocations_);
+            run_stripes();
+        }
+        lock.lock();
+        if(--busy_workers_ == 0)
+        {
+            done_cv_.notify_one();
+        }
+    }
+}
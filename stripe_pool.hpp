@@ -0,0 +1,207 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocation_check.hpp"
+#include "tracer.hpp"
+
+// Non-owning reference to a callable, cheap to pass to the stripe pool
+// without the heap allocation `std::function` may need for captures.
+template<typename Signature>
+class function_ref;
+
+template<typename R, typename... Args>
+class function_ref<R(Args...)>
+{
+public:
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, function_ref>>>
+    function_ref(F&& callable) noexcept
+        : object_(const_cast<void*>(static_cast<const void*>(std::addressof(callable))))
+        , call_([](void* object, Args... args) -> R { return (*static_cast<std::remove_reference_t<F>*>(object))(std::forward<Args>(args)...); })
+    {
+    }
+
+    R operator()(Args... args) const
+    {
+        return call_(object_, std::forward<Args>(args)...);
+    }
+
+private:
+    void* object_;
+    R (*call_)(void*, Args...);
+};
+
+// Worker threads that split per-frame work into horizontal stripes.
+// The calling thread takes part in the work; concurrent callers are served
+// one at a time, earliest frame deadline first (see `deadline_scope`) and in
+// arrival order among equal deadlines.
+class stripe_pool
+{
+public:
+    using task = function_ref<void(uint32_t begin, uint32_t end)>;
+
+    explicit stripe_pool(size_t threads);
+
+    ~stripe_pool();
+
+    stripe_pool(const stripe_pool&) = delete;
+    stripe_pool& operator=(const stripe_pool&) = delete;
+
+    size_t concurrency() const noexcept
+    {
+        return workers_.size() + 1;
+    }
+
+    // Index of the calling thread in [0, concurrency()) while it runs a stripe,
+    // for per-thread scratch space. Callers of `run()` use slot 0; this is safe
+    // for scratch owned by a filter since a filter is only applied by its own stream.
+    static uint32_t slot() noexcept
+    {
+        return slot_;
+    }
+
+    // sets the deadline of the frame the calling thread works on, for the order of `run()` calls
+    class deadline_scope
+    {
+    public:
+        explicit deadline_scope(std::chrono::steady_clock::time_point deadline) noexcept
+            : previous_(std::exchange(deadline_, deadline))
+        {
+        }
+
+        ~deadline_scope()
+        {
+            deadline_ = previous_;
+        }
+
+        deadline_scope(const deadline_scope&) = delete;
+        deadline_scope& operator=(const deadline_scope&) = delete;
+
+    private:
+        const std::chrono::steady_clock::time_point previous_;
+    };
+
+    uint32_t stripe_count(uint32_t rows) const noexcept
+    {
+        return static_cast<uint32_t>(std::min<size_t>(rows, concurrency()));
+    }
+
+    static uint32_t stripe_begin(uint32_t rows, uint32_t stripes, uint32_t stripe) noexcept
+    {
+        return static_cast<uint32_t>(uint64_t(rows) * stripe / stripes);
+    }
+
+    // calls `work(begin, end)` for disjoint row ranges covering [0, rows),
+    // split as `stripe_count()` and `stripe_begin()` describe
+    void run(uint32_t rows, task work);
+
+private:
+    // Place of a `run()` call in the queue for the pool, kept on the caller's
+    // stack and linked in deadline order, so waiting never allocates.
+    class admission
+    {
+    public:
+        explicit admission(stripe_pool& pool)
+            : pool_(pool)
+            , deadline_(stripe_pool::deadline_)
+        {
+            std::unique_lock<std::mutex> lock(pool_.admission_mutex_);
+            ticket_ = pool_.next_ticket_++;
+            auto link = &pool_.waiting_;
+            while(*link != nullptr && !precedes(*this, **link))
+            {
+                link = &(*link)->next_;
+            }
+            next_ = *link;
+            *link = this;
+            pool_.admission_cv_.wait(lock, [this](){ return !pool_.admitted_ && pool_.waiting_ == this; });
+            pool_.waiting_ = next_;
+            pool_.admitted_ = true;
+        }
+
+        ~admission()
+        {
+            {
+                std::scoped_lock<std::mutex> lock(pool_.admission_mutex_);
+                pool_.admitted_ = false;
+            }
+            pool_.admission_cv_.notify_all();
+        }
+
+        admission(const admission&) = delete;
+        admission& operator=(const admission&) = delete;
+
+    private:
+        static bool precedes(const admission& a, const admission& b) noexcept
+        {
+            return a.deadline_ < b.deadline_ || (a.deadline_ == b.deadline_ && a.ticket_ < b.ticket_);
+        }
+
+        stripe_pool& pool_;
+        const std::chrono::steady_clock::time_point deadline_;
+        uint64_t ticket_ = 0;
+        admission* next_ = nullptr;
+    };
+
+    void run_stripes();
+
+    void worker_loop();
+
+    static inline thread_local uint32_t slot_ = 0;
+    static inline thread_local std::chrono::steady_clock::time_point deadline_ = std::chrono::steady_clock::time_point::max();
+
+    std::vector<std::thread> workers_;
+    std::mutex admission_mutex_;
+    std::condition_variable admission_cv_;
+    admission* waiting_ = nullptr; // callers of `run()` in service order
+    bool admitted_ = false;
+    uint64_t next_ticket_ = 0;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    size_t busy_workers_ = 0;
+    bool stop_ = false;
+    const task* task_ = nullptr;
+    tracer::context trace_context_{nullptr, 0}; // of the `run()` caller
+    const char* perf_stage_ = nullptr;
+    bool count_allocations_ = false;          // the caller's frame is checked by `allocation_check`
+    std::atomic<uint64_t> worker_allocations_{0};
+    uint32_t rows_ = 0;
+    uint32_t stripes_ = 0;
+    std::atomic<uint32_t> next_stripe_{0};
+};
@@ -0,0 +1,163 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "temporal_denoise_filter.hpp"
+
+// std
+#include <cstring>
+#include <stdexcept>
+
+temporal_denoise_filter::temporal_denoise_filter(const nlohmann::json& config)
+{
+    const auto mode = config.value("mode", "exponential");
+    if(mode == "exponential")
+    {
+        const auto alpha = config.value("alpha", 0.25);
+        if(!(alpha > 0.0 && alpha <= 1.0))
+        {
+            throw std::runtime_error("`alpha` must be in (0, 1]");
+        }
+        alpha_ = static_cast<int32_t>(alpha * 256.0 + 0.5);
+    }
+    else if(mode == "average")
+    {
+        frames_ = config.value("frames", 4u);
+        if(frames_ < 2 || frames_ > 16)
+        {
+            throw std::runtime_error("`frames` must be in [2, 16]");
+        }
+        reciprocal_ = (65536u + frames_ - 1) / frames_;
+    }
+    else
+    {
+        throw std::runtime_error("unknown `mode` `" + mode + "`");
+    }
+    threshold_ = config.value("motion_threshold", 24);
+    if(threshold_ < 0 || threshold_ > 255)
+    {
+        throw std::runtime_error("`motion_threshold` must be in [0, 255]");
+    }
+}
+
+void temporal_denoise_filter::apply(const frame_view& frame, stripe_pool& pool)
+{
+    const auto row_size = frame.row_size();
+    const bool primed = prepare(frame);
+    pool.run(frame.height, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = begin; y < end; ++y)
+        {
+            const auto offset = y * row_size;
+            if(frames_ == 0)
+            {
+                exponential_row(frame.row(y), history_.data() + offset, row_size, primed);
+            }
+            else
+            {
+                average_row(frame.row(y), offset, row_size, primed);
+            }
+        }
+    });
+    next_slot_ = frames_ != 0 ? (next_slot_ + 1) % frames_ : 0;
+}
+
+bool temporal_denoise_filter::prepare(const frame_view& frame)
+{
+    if(frame.width == width_ && frame.height == height_ && frame.channels == channels_)
+    {
+        return true;
+    }
+    width_ = frame.width;
+    height_ = frame.height;
+    channels_ = frame.channels;
+    const auto samples = frame.row_size() * frame.height;
+    if(frames_ == 0)
+    {
+        history_.assign(samples, 0);
+    }
+    else
+    {
+        ring_.assign(samples * frames_, 0);
+        sum_.assign(samples, 0);
+        next_slot_ = 0;
+    }
+    return false;
+}
+
+void temporal_denoise_filter::exponential_row(uint8_t* const pixels, uint16_t* const history, const size_t count, const bool primed) const noexcept
+{
+    if(!primed)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            history[i] = static_cast<uint16_t>(pixels[i] << 8);
+        }
+        return;
+    }
+    const int32_t alpha = alpha_;
+    const int32_t threshold = threshold_ << 8;
+    for(size_t i = 0; i < count; ++i)
+    {
+        const int32_t current = pixels[i] << 8;
+        const int32_t previous = history[i];
+        const int32_t difference = current - previous;
+        const int32_t magnitude = difference < 0 ? -difference : difference;
+        const int32_t blended = previous + ((difference * alpha) >> 8);
+        const int32_t next = magnitude > threshold ? current : blended;
+        history[i] = static_cast<uint16_t>(next);
+        pixels[i] = static_cast<uint8_t>((next + 128) >> 8);
+    }
+}
+
+void temporal_denoise_filter::average_row(uint8_t* const pixels, const size_t offset, const size_t count, const bool primed) noexcept
+{
+    const auto samples = sum_.size();
+    uint16_t* const sum = sum_.data() + offset;
+    uint8_t* const oldest = ring_.data() + next_slot_ * samples + offset;
+    if(!primed)
+    {
+        for(uint32_t slot = 0; slot < frames_; ++slot)
+        {
+            std::memcpy(ring_.data() + slot * samples + offset, pixels, count);
+        }
+        for(size_t i = 0; i < count; ++i)
+        {
+            sum[i] = static_cast<uint16_t>(pixels[i] * frames_);
+        }
+        return;
+    }
+    const uint32_t reciprocal = reciprocal_;
+    const int32_t threshold = threshold_;
+    for(size_t i = 0; i < count; ++i)
+    {
+        const uint32_t current = pixels[i];
+        const uint32_t total = sum[i] - oldest[i] + current;
+        sum[i] = static_cast<uint16_t>(total);
+        oldest[i] = static_cast<uint8_t>(current);
+        const int32_t mean = static_cast<int32_t>((total * reciprocal) >> 16);
+        const int32_t difference = static_cast<int32_t>(current) - mean;
+        const int32_t magnitude = difference < 0 ? -difference : difference;
+        pixels[i] = static_cast<uint8_t>(magnitude > threshold ? static_cast<int32_t>(current) : mean);
+    }
+}
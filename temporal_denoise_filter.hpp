@@ -0,0 +1,72 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Recursive temporal noise reduction. Each sample is blended with its history
+// unless it differs from it by more than `motion_threshold`, in which case
+// the pixel is taken as moving and passed through unchanged.
+// `exponential` mode keeps one 8.8 fixed-point history frame (weight of the new
+// frame is `alpha`); `average` mode keeps a ring of the last `frames` frames
+// together with their running sum and outputs the mean.
+// Row kernels are branch-free integer loops that compilers vectorize.
+class temporal_denoise_filter final : public filter
+{
+public:
+    explicit temporal_denoise_filter(const nlohmann::json& config);
+
+    void apply(const frame_view& frame, stripe_pool& pool) override;
+
+private:
+    // (re)allocates history on first frame or geometry change; returns whether history is valid
+    bool prepare(const frame_view& frame);
+
+    void exponential_row(uint8_t* const pixels, uint16_t* const history, const size_t count, const bool primed) const noexcept;
+
+    void average_row(uint8_t* const pixels, const size_t offset, const size_t count, const bool primed) noexcept;
+
+    int32_t alpha_ = 0;
+    uint32_t frames_ = 0;
+    uint32_t reciprocal_ = 0;
+    int32_t threshold_ = 0;
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t channels_ = 0;
+    std::vector<uint16_t> history_;
+    std::vector<uint8_t> ring_;
+    std::vector<uint16_t> sum_;
+    uint32_t next_slot_ = 0;
+};
@@ -0,0 +1,164 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tracer.hpp"
+
+// std
+#include <algorithm>
+#include <fstream>
+#include <tuple>
+
+// json
+#include <nlohmann/json.hpp>
+
+// IFF SDK
+#include <iffwrapper.hpp>
+namespace iff = iffwrapper;
+
+#include "allocation_check.hpp"
+
+void tracer::name_thread(const std::string& name)
+{
+    thread_name_ = name;
+    if(const auto active = instance(); active != nullptr && ring_ != nullptr)
+    {
+        std::scoped_lock<std::mutex> lock(active->rings_mutex_);
+        ring_->thread_name = name;
+    }
+}
+
+void tracer::start()
+{
+    instance_.store(this, std::memory_order_release);
+#ifdef SIGUSR1
+    previous_handler_ = std::signal(SIGUSR1, [](int){ dump_requested_.store(true, std::memory_order_relaxed); });
+    writer_ = std::thread([this]()
+    {
+        std::unique_lock<std::mutex> lock(writer_mutex_);
+        while(!writer_cv_.wait_for(lock, std::chrono::milliseconds(100), [this](){ return stop_; }))
+        {
+            if(dump_requested_.exchange(false, std::memory_order_relaxed))
+            {
+                write();
+            }
+        }
+    });
+#endif
+}
+
+void tracer::stop()
+{
+    if(instance() != this)
+    {
+        return;
+    }
+#ifdef SIGUSR1
+    {
+        std::scoped_lock<std::mutex> lock(writer_mutex_);
+        stop_ = true;
+    }
+    writer_cv_.notify_all();
+    writer_.join();
+#endif
+    write();
+    instance_.store(nullptr, std::memory_order_release);
+#ifdef SIGUSR1
+    // a late dump request must not terminate the shutdown, as the default action would
+    std::signal(SIGUSR1, previous_handler_ == SIG_DFL || previous_handler_ == SIG_ERR ? SIG_IGN : previous_handler_);
+#endif
+}
+
+void tracer::record(const char* name, const context& frame, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) noexcept
+{
+    auto& ring = local();
+    const auto index = ring.count.load(std::memory_order_relaxed);
+    auto& e = ring.entries[index % ring.entries.size()];
+    e.name.store(name, std::memory_order_relaxed);
+    e.stream.store(frame.stream, std::memory_order_relaxed);
+    e.frame.store(frame.frame, std::memory_order_relaxed);
+    e.begin.store((begin - origin_).count(), std::memory_order_relaxed);
+    e.end.store((end - origin_).count(), std::memory_order_relaxed);
+    ring.count.store(index + 1, std::memory_order_release);
+}
+
+tracer::ring& tracer::local()
+{
+    if(ring_owner_ != this)
+    {
+        const allocation_check::exempt registration; // once per thread
+        std::scoped_lock<std::mutex> lock(rings_mutex_);
+        const auto id = static_cast<uint32_t>(rings_.size() + 1);
+        rings_.push_back(std::make_unique<ring>(capacity_, id, thread_name_.empty() ? "thread " + std::to_string(id) : thread_name_));
+        ring_ = rings_.back().get();
+        ring_owner_ = this;
+    }
+    return *ring_;
+}
+
+void tracer::write()
+{
+    std::ofstream file(path_);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    size_t spans = 0;
+    bool first = true;
+    const auto separator = [&]() -> std::ostream& { file << (first ? "" : ",\n"); first = false; return file; };
+    const auto us = [](int64_t ticks){ return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(ticks)).count(); };
+    std::scoped_lock<std::mutex> lock(rings_mutex_);
+    for(const auto& r : rings_)
+    {
+        separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r->thread_id
+                    << ",\"args\":{\"name\":" << nlohmann::json(r->thread_name).dump() << "}}";
+        const auto size = r->entries.size();
+        const auto end = r->count.load(std::memory_order_acquire);
+        auto begin = end > size ? end - size : 0;
+        std::vector<std::tuple<const char*, const char*, uint64_t, int64_t, int64_t>> copied;
+        copied.reserve(end - begin);
+        for(auto i = begin; i < end; ++i)
+        {
+            const auto& e = r->entries[i % size];
+            copied.emplace_back(e.name.load(std::memory_order_relaxed), e.stream.load(std::memory_order_relaxed), e.frame.load(std::memory_order_relaxed),
+                                e.begin.load(std::memory_order_relaxed), e.end.load(std::memory_order_relaxed));
+        }
+        // spans the thread wrote meanwhile replaced the oldest ones copied, and the slot
+        // of the span it may be writing now (entry `overwritten`) can be half-written
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto overwritten = r->count.load(std::memory_order_relaxed);
+        const auto valid = overwritten + 1 > size ? std::max(begin, overwritten + 1 - size) : begin;
+        for(auto i = valid; i < end; ++i)
+        {
+            const auto& [name, stream, frame, span_begin, span_end] = copied[i - begin];
+            separator() << "{\"name\":" << nlohmann::json(name).dump() << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << r->thread_id
+                        << ",\"ts\":" << us(span_begin) << ",\"dur\":" << us(span_end - span_begin) << ",\"args\":{";
+            if(stream != nullptr)
+            {
+                file << "\"stream\":" << nlohmann::json(stream).dump() << ",\"frame\":" << frame;
+            }
+            file << "}}";
+            ++spans;
+        }
+    }
+    file << "\n]}\n";
+    iff::log(file ? iff::log_level::info : iff::log_level::error, "imagefiltercpp",
+             (file ? "Trace with " + std::to_string(spans) + " spans written to " : "Failed to write trace to ") + path_);
+}
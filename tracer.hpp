@@ -0,0 +1,196 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Records timed spans of the frame path and writes them as Chrome trace-event
+// JSON, for chrome://tracing or Perfetto. Every thread appends to its own
+// ring of `capacity` spans and publishes it with a release store, so
+// recording takes no lock; a snapshot drops the spans a thread may have
+// overwritten while they were copied. The trace is written on `stop()` and,
+// where SIGUSR1 exists, whenever the process receives it. Without an active
+// tracer a span costs one load and a branch.
+class tracer
+{
+public:
+    // what a span belongs to; stripe tasks inherit the context of the `run()` caller
+    struct context
+    {
+        const char* stream;
+        uint64_t frame;
+    };
+
+    // times the enclosing scope
+    class span
+    {
+    public:
+        explicit span(const char* name, const context& frame = current()) noexcept
+            : tracer_(instance())
+            , name_(name)
+            , context_(frame)
+        {
+            if(tracer_ != nullptr)
+            {
+                begin_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~span()
+        {
+            if(tracer_ != nullptr)
+            {
+                tracer_->record(name_, context_, begin_, std::chrono::steady_clock::now());
+            }
+        }
+
+        span(const span&) = delete;
+        span& operator=(const span&) = delete;
+
+    private:
+        tracer* const tracer_;
+        const char* const name_;
+        const context context_;
+        std::chrono::steady_clock::time_point begin_;
+    };
+
+    // sets the context of spans made by the calling thread
+    class context_scope
+    {
+    public:
+        context_scope(const char* stream, uint64_t frame) noexcept
+            : previous_(std::exchange(current_, context{stream, frame}))
+        {
+        }
+
+        ~context_scope()
+        {
+            current_ = previous_;
+        }
+
+        context_scope(const context_scope&) = delete;
+        context_scope& operator=(const context_scope&) = delete;
+
+    private:
+        const context previous_;
+    };
+
+    tracer(std::string path, size_t capacity)
+        : path_(std::move(path))
+        , capacity_(capacity)
+        , origin_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~tracer()
+    {
+        stop();
+    }
+
+    tracer(const tracer&) = delete;
+    tracer& operator=(const tracer&) = delete;
+
+    static tracer* instance() noexcept
+    {
+        return instance_.load(std::memory_order_acquire);
+    }
+
+    static const context& current() noexcept
+    {
+        return current_;
+    }
+
+    // names the calling thread in the trace
+    static void name_thread(const std::string& name);
+
+    void start();
+
+    // writes the final trace; span names and stream ids must still be alive
+    void stop();
+
+    void record(const char* name, const context& frame, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) noexcept;
+
+private:
+    struct entry
+    {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<const char*> stream{nullptr};
+        std::atomic<uint64_t> frame{0};
+        std::atomic<int64_t> begin{0}; // steady clock ticks since `origin_`
+        std::atomic<int64_t> end{0};
+    };
+
+    struct ring
+    {
+        explicit ring(size_t capacity, uint32_t id, std::string name)
+            : entries(capacity)
+            , thread_id(id)
+            , thread_name(std::move(name))
+        {
+        }
+
+        std::vector<entry> entries;
+        std::atomic<uint64_t> count{0};
+        const uint32_t thread_id;
+        std::string thread_name; // guarded by `rings_mutex_`
+    };
+
+    // ring of the calling thread, created on its first span
+    ring& local();
+
+    void write();
+
+    static inline std::atomic<tracer*> instance_{nullptr};
+    static inline std::atomic<bool> dump_requested_{false};
+    static inline thread_local context current_{nullptr, 0};
+    static inline thread_local ring* ring_ = nullptr;
+    static inline thread_local const tracer* ring_owner_ = nullptr;
+    static inline thread_local std::string thread_name_;
+
+    const std::string path_;
+    const size_t capacity_;
+    const std::chrono::steady_clock::time_point origin_;
+    std::mutex rings_mutex_;
+    std::vector<std::unique_ptr<ring>> rings_;
+
+    std::mutex writer_mutex_;
+    std::condition_variable writer_cv_;
+    bool stop_ = false;
+    std::thread writer_;
+#ifdef SIGUSR1
+    void (*previous_handler_)(int) = SIG_DFL;
+#endif
+};
@@ -0,0 +1,195 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "undistort_filter.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+undistort_filter::undistort_filter(const nlohmann::json& config)
+    : fx_(config.at("fx").get<double>())
+    , fy_(config.at("fy").get<double>())
+    , cx_(config.value("cx", -1.0))
+    , cy_(config.value("cy", -1.0))
+    , k1_(config.value("k1", 0.0))
+    , k2_(config.value("k2", 0.0))
+    , k3_(config.value("k3", 0.0))
+    , p1_(config.value("p1", 0.0))
+    , p2_(config.value("p2", 0.0))
+    , calibration_width_(config.value("width", 0u))
+    , calibration_height_(config.value("height", 0u))
+{
+    if(!(fx_ > 0.0 && fy_ > 0.0))
+    {
+        throw std::runtime_error("`fx` and `fy` must be positive");
+    }
+    if((calibration_width_ == 0) != (calibration_height_ == 0))
+    {
+        throw std::runtime_error("`width` and `height` must be given together");
+    }
+    if(calibration_width_ >= 2 && calibration_height_ >= 2)
+    {
+        build_map(calibration_width_, calibration_height_);
+    }
+}
+
+void undistort_filter::apply(const frame_view& frame, stripe_pool& pool)
+{
+    if(frame.width < 2 || frame.height < 2)
+    {
+        return;
+    }
+    if(frame.width != width_ || frame.height != height_)
+    {
+        build_map(frame.width, frame.height);
+    }
+    const auto row_size = frame.row_size();
+    if(frame.channels != channels_)
+    {
+        channels_ = frame.channels;
+        // one spare row and pixel, read with zero weight at the last row and column
+        source_.assign(row_size * (height_ + 1) + channels_, 0);
+    }
+    pool.run(frame.height, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t y = begin; y < end; ++y)
+        {
+            std::memcpy(source_.data() + y * row_size, frame.row(y), row_size);
+        }
+    });
+    pool.run(tiles_y_, [&](uint32_t begin, uint32_t end)
+    {
+        for(uint32_t tile_y = begin; tile_y < end; ++tile_y)
+        {
+            for(uint32_t tile_x = 0; tile_x < tiles_x_; ++tile_x)
+            {
+                switch(channels_)
+                {
+                case 1:
+                    remap_tile<1>(frame, tile_x, tile_y);
+                    break;
+                case 3:
+                    remap_tile<3>(frame, tile_x, tile_y);
+                    break;
+                default:
+                    remap_tile<4>(frame, tile_x, tile_y);
+                    break;
+                }
+            }
+        }
+    });
+}
+
+void undistort_filter::build_map(uint32_t width, uint32_t height)
+{
+    width_ = width;
+    height_ = height;
+    channels_ = 0;
+    tiles_x_ = (width_ + TILE_SIZE - 1) / TILE_SIZE;
+    tiles_y_ = (height_ + TILE_SIZE - 1) / TILE_SIZE;
+    map_.assign(size_t(tiles_x_) * tiles_y_ * TILE_SIZE * TILE_SIZE, entry{-1, -1, 0, 0});
+
+    const double scale_x = calibration_width_ != 0 ? double(width_) / calibration_width_ : 1.0;
+    const double scale_y = calibration_height_ != 0 ? double(height_) / calibration_height_ : 1.0;
+    const double fx = fx_ * scale_x;
+    const double fy = fy_ * scale_y;
+    const double cx = cx_ >= 0.0 ? cx_ * scale_x : (width_ - 1) / 2.0;
+    const double cy = cy_ >= 0.0 ? cy_ * scale_y : (height_ - 1) / 2.0;
+    // position of the top-left pixel of the 2x2 neighbourhood and the fraction towards the next
+    const auto split = [](double position, int16_t& index, uint8_t& fraction)
+    {
+        auto whole = static_cast<int32_t>(position);
+        auto rest = static_cast<int32_t>(std::lround((position - whole) * 256.0));
+        if(rest == 256)
+        {
+            ++whole;
+            rest = 0;
+        }
+        index = static_cast<int16_t>(whole);
+        fraction = static_cast<uint8_t>(rest);
+    };
+    for(uint32_t v = 0; v < height_; ++v)
+    {
+        for(uint32_t u = 0; u < width_; ++u)
+        {
+            const double x = (u - cx) / fx;
+            const double y = (v - cy) / fy;
+            const double r2 = x * x + y * y;
+            const double radial = 1.0 + r2 * (k1_ + r2 * (k2_ + r2 * k3_));
+            const double source_x = fx * (x * radial + 2.0 * p1_ * x * y + p2_ * (r2 + 2.0 * x * x)) + cx;
+            const double source_y = fy * (y * radial + p1_ * (r2 + 2.0 * y * y) + 2.0 * p2_ * x * y) + cy;
+            if(!(source_x >= 0.0 && source_y >= 0.0 && source_x <= width_ - 1.0 && source_y <= height_ - 1.0))
+            {
+                continue;
+            }
+            auto& e = map_[map_index(u, v)];
+            split(source_x, e.x, e.fraction_x);
+            split(source_y, e.y, e.fraction_y);
+        }
+    }
+}
+
+template<uint32_t Channels>
+void undistort_filter::remap_tile(const frame_view& frame, uint32_t tile_x, uint32_t tile_y) const noexcept
+{
+    const size_t source_stride = size_t(width_) * Channels;
+    const uint8_t* const source = source_.data();
+    const entry* entries = map_.data() + (size_t(tile_y) * tiles_x_ + tile_x) * TILE_SIZE * TILE_SIZE;
+    const auto x_begin = tile_x * TILE_SIZE;
+    const auto x_end = std::min(x_begin + TILE_SIZE, width_);
+    const auto y_end = std::min((tile_y + 1) * TILE_SIZE, height_);
+    for(uint32_t y = tile_y * TILE_SIZE; y < y_end; ++y, entries += TILE_SIZE)
+    {
+        uint8_t* output = frame.row(y) + size_t(x_begin) * Channels;
+        for(uint32_t x = x_begin; x < x_end; ++x, output += Channels)
+        {
+            const auto& e = entries[x - x_begin];
+            if(e.x < 0)
+            {
+                for(uint32_t c = 0; c < Channels; ++c)
+                {
+                    output[c] = 0;
+                }
+                continue;
+            }
+            // corner weights are shared by all channels
+            const uint32_t fx = e.fraction_x;
+            const uint32_t fy = e.fraction_y;
+            const uint32_t bottom_right = fx * fy;
+            const uint32_t top_right = (fx << 8) - bottom_right;
+            const uint32_t bottom_left = (fy << 8) - bottom_right;
+            const uint32_t top_left = 65536 - top_right - bottom_left - bottom_right;
+            const uint8_t* const top = source + e.y * source_stride + e.x * Channels;
+            const uint8_t* const bottom = top + source_stride;
+            for(uint32_t c = 0; c < Channels; ++c)
+            {
+                output[c] = static_cast<uint8_t>((top[c] * top_left + top[c + Channels] * top_right
+                                                  + bottom[c] * bottom_left + bottom[c + Channels] * bottom_right + 32768) >> 16);
+            }
+        }
+    }
+}
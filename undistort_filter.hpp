@@ -0,0 +1,87 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "stripe_pool.hpp"
+
+// Lens distortion correction for the radial-tangential model used by OpenCV
+// calibration: focal lengths `fx`, `fy` and principal point `cx`, `cy` in
+// pixels (of a `width` x `height` calibration, if given, scaled to the frame),
+// radial `k1`, `k2`, `k3` and tangential `p1`, `p2` coefficients. The source
+// position of every output pixel is computed once (at startup when the
+// calibration size is given and matches the frames) into a fixed-point map
+// stored in 32x32 tiles, so a tile reads contiguous entries and
+// a compact window of source pixels. Per frame the image is copied aside and
+// resampled bilinearly tile by tile, rows of tiles split over the stripe pool;
+// pixels that map outside of the frame become black.
+class undistort_filter final : public filter
+{
+public:
+    explicit undistort_filter(const nlohmann::json& config);
+
+    void apply(const frame_view& frame, stripe_pool& pool) override;
+
+private:
+    static constexpr uint32_t TILE_SIZE = 32;
+
+    // top-left source pixel and 8-bit fractions towards the next one; x < 0 outside of the frame
+    struct entry
+    {
+        int16_t x, y;
+        uint8_t fraction_x, fraction_y;
+    };
+
+    void build_map(uint32_t width, uint32_t height);
+
+    size_t map_index(uint32_t x, uint32_t y) const noexcept
+    {
+        const size_t tile = size_t(y / TILE_SIZE) * tiles_x_ + x / TILE_SIZE;
+        return tile * TILE_SIZE * TILE_SIZE + (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE;
+    }
+
+    template<uint32_t Channels>
+    void remap_tile(const frame_view& frame, uint32_t tile_x, uint32_t tile_y) const noexcept;
+
+    const double fx_, fy_, cx_, cy_;
+    const double k1_, k2_, k3_, p1_, p2_;
+    const uint32_t calibration_width_, calibration_height_;
+
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t channels_ = 0;
+    uint32_t tiles_x_ = 0;
+    uint32_t tiles_y_ = 0;
+    std::vector<entry> map_;
+    std::vector<uint8_t> source_; // copy of the frame being corrected
+};
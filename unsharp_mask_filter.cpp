@@ -0,0 +1,81 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "unsharp_mask_filter.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+unsharp_mask_filter::unsharp_mask_filter(const nlohmann::json& config, double default_sigma)
+    : convolution_(gaussian_kernel(config, default_sigma))
+{
+    const auto amount = config.value("amount", 1.0);
+    if(!(amount > 0.0 && amount <= 4.0))
+    {
+        throw std::runtime_error("`amount` must be in (0, 4]");
+    }
+    amount_ = static_cast<int16_t>(amount * 4096.0 + 0.5); // applied to difference * 16 as multiply-high
+    const auto threshold = config.value("threshold", 0);
+    if(threshold < 0 || threshold > 255)
+    {
+        throw std::runtime_error("`threshold` must be in [0, 255]");
+    }
+    threshold_ = static_cast<int16_t>(threshold);
+}
+
+std::vector<int32_t> unsharp_mask_filter::gaussian_kernel(const nlohmann::json& config, double default_sigma)
+{
+    const auto sigma = config.value("sigma", default_sigma);
+    if(!(sigma > 0.0 && sigma <= 5.0))
+    {
+        throw std::runtime_error("`sigma` must be in (0, 5]");
+    }
+    const auto radius = config.value("radius", static_cast<uint32_t>(std::ceil(3.0 * sigma)));
+    if(radius == 0 || radius > 15)
+    {
+        throw std::runtime_error("`radius` must be in [1, 15]");
+    }
+    return separable_convolution::gaussian(sigma, radius);
+}
+
+void unsharp_mask_filter::apply(const frame_view& frame, stripe_pool& pool)
+{
+    const int16_t amount = amount_;
+    const int16_t threshold = threshold_;
+    convolution_.apply(frame, pool, [amount, threshold](const uint8_t* blurred, uint8_t* destination, size_t count)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            // all in 16 bits; the scaled product is a signed multiply-high
+            const int16_t source = destination[i];
+            const int16_t difference = static_cast<int16_t>(source - blurred[i]);
+            const int16_t magnitude = static_cast<int16_t>(difference < 0 ? -difference : difference);
+            const int16_t boost = static_cast<int16_t>((int32_t(int16_t(difference * 16)) * amount) >> 16);
+            const int16_t sharpened = std::clamp<int16_t>(static_cast<int16_t>(source + boost), 0, 255);
+            destination[i] = static_cast<uint8_t>(magnitude > threshold ? sharpened : source);
+        }
+    });
+}
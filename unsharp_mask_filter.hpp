@@ -0,0 +1,59 @@
+/*
+ * IFF SDK samples (https://mr-te.ch/iff-sdk) are licensed under MIT License.
+ *
+ * Copyright (c) 2022-2025 MRTech SK, s.r.o.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+// json
+#include <nlohmann/json.hpp>
+
+#include "filter.hpp"
+#include "frame_view.hpp"
+#include "separable_convolution.hpp"
+#include "stripe_pool.hpp"
+
+// `unsharp_mask` (and `sharpen` with a smaller default radius) filter:
+// adds `amount` times the difference from a Gaussian-blurred copy where it exceeds `threshold`.
+class unsharp_mask_filter final : public filter
+{
+public:
+    unsharp_mask_filter(const nlohmann::json& config, double default_sigma);
+
+    static std::vector<int32_t> gaussian_kernel(const nlohmann::json& config, double default_sigma);
+
+    bool scale_invariant() const noexcept override
+    {
+        return true;
+    }
+
+    void apply(const frame_view& frame, stripe_pool& pool) override;
+
+private:
+    separable_convolution convolution_;
+    int16_t amount_ = 0;
+    int16_t threshold_ = 0;
+};